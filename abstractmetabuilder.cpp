@@ -27,6 +27,8 @@
 
 #include "parser/ast.h"
 #include "parser/binder.h"
+#include "parser/codemodel_partition.h"
+#include "parser/codemodel_snapshot.h"
 #include "parser/control.h"
 #include "parser/default_visitor.h"
 #include "parser/dumptree.h"
@@ -34,6 +36,7 @@
 #include "parser/parser.h"
 #include "parser/tokens.h"
 
+#include <QBuffer>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
@@ -48,6 +51,27 @@
 #include <algorithm>
 #include "graph.h"
 #include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
+
+// Writes data to a temporary file next to path and moves it into place, so
+// that a crash or a concurrent build never leaves a truncated file behind.
+static bool writeFileAtomically(const QString &path, const QByteArray &data)
+{
+    QTemporaryFile file(path + ".XXXXXX");
+    if (!file.open() || file.write(data) != data.size() || !file.flush())
+        return false;
+    file.close();
+
+    if (::rename(QFile::encodeName(file.fileName()).constData(), QFile::encodeName(path).constData()) != 0) {
+        // rename() does not replace existing files everywhere (e.g. Windows)
+        QFile::remove(path);
+        if (!QFile::rename(file.fileName(), path))
+            return false;
+    }
+    file.setAutoRemove(false);
+    return true;
+}
 
 static QString stripTemplateArgs(const QString &name)
 {
@@ -55,7 +79,9 @@ static QString stripTemplateArgs(const QString &name)
     return pos < 0 ? name : name.left(pos);
 }
 
-AbstractMetaBuilder::AbstractMetaBuilder() : m_currentClass(0), m_logDirectory(QString('.')+QDir::separator())
+AbstractMetaBuilder::AbstractMetaBuilder() : m_codeModel(0), m_currentClass(0), m_logDirectory(QString('.')+QDir::separator()),
+                                             m_threadCount(1), m_translatedTypeHits(0), m_translatedTypeMisses(0),
+                                             m_translationUsesClass(false)
 {
 }
 
@@ -65,6 +91,8 @@ AbstractMetaBuilder::~AbstractMetaBuilder()
     qDeleteAll(m_globalFunctions);
     qDeleteAll(m_templates);
     qDeleteAll(m_metaClasses);
+    clearTranslatedTypes();
+    delete m_codeModel;
 }
 
 void AbstractMetaBuilder::checkFunctionModifications()
@@ -88,7 +116,7 @@ void AbstractMetaBuilder::checkFunctionModifications()
             QString name = signature.trimmed();
             name = name.mid(0, signature.indexOf("("));
 
-            AbstractMetaClass* clazz = m_metaClasses.findClass(centry->qualifiedCppName());
+            AbstractMetaClass* clazz = findMetaClass(centry->qualifiedCppName());
             if (!clazz)
                 continue;
 
@@ -125,7 +153,7 @@ AbstractMetaClass* AbstractMetaBuilder::argumentToClass(ArgumentModelItem argume
     AbstractMetaType* type = translateType(argument->type(), &ok);
     if (ok && type && type->typeEntry() && type->typeEntry()->isComplex()) {
         const TypeEntry *entry = type->typeEntry();
-        returned = m_metaClasses.findClass(entry->name());
+        returned = findMetaClass(entry->name());
     }
     delete type;
     return returned;
@@ -188,7 +216,7 @@ void AbstractMetaBuilder::traverseOperatorFunction(FunctionModelItem item)
             && (retType->isValue() || retType->isObject())
             && retType != baseoperandClass->typeEntry()
             && retType == otherArgClass->typeEntry()) {
-            baseoperandClass = m_metaClasses.findClass(retType);
+            baseoperandClass = findMetaClass(retType);
             firstArgumentIsSelf = false;
         }
         delete type;
@@ -295,7 +323,13 @@ void AbstractMetaBuilder::traverseStreamOperator(FunctionModelItem item)
 void AbstractMetaBuilder::fixQObjectForScope(TypeDatabase *types,
                                              NamespaceModelItem scope)
 {
-    foreach (ClassModelItem item, scope->classes()) {
+    const QHash<QString, ClassModelItem> &classMap = scope->classMap();
+    for (QHash<QString, ClassModelItem>::const_iterator it = classMap.constBegin(); it != classMap.constEnd(); ++it) {
+        const ClassModelItem &item = it.value();
+        // template classes are also listed under their name without arguments
+        if (it.key() != item->name())
+            continue;
+
         QString qualifiedName = item->qualifiedName().join("::");
         TypeEntry* entry = types->findType(qualifiedName);
         if (entry) {
@@ -304,9 +338,10 @@ void AbstractMetaBuilder::fixQObjectForScope(TypeDatabase *types,
         }
     }
 
-    foreach (NamespaceModelItem item, scope->namespaceMap().values()) {
-        if (scope != item)
-            fixQObjectForScope(types, item);
+    const QHash<QString, NamespaceModelItem> &namespaceMap = scope->namespaceMap();
+    for (QHash<QString, NamespaceModelItem>::const_iterator it = namespaceMap.constBegin(); it != namespaceMap.constEnd(); ++it) {
+        if (scope != it.value())
+            fixQObjectForScope(types, it.value());
     }
 }
 
@@ -330,19 +365,92 @@ bool AbstractMetaBuilder::build(QIODevice* input)
     QByteArray contents = input->readAll();
     input->close();
 
-    Control control;
-    Parser p(&control);
-    pool __pool;
+    // The model items are released with the model, so it is kept for as
+    // long as model() may hand them out.
+    m_scopes.clear();
+    m_dom = FileModelItem();
+    delete m_codeModel;
+    m_codeModel = new CodeModel;
+
+    QByteArray fingerprint;
+    QString snapshotPath;
+    CodeModelPartition::FingerprintMap partitions;
+    if (!m_snapshotDirectory.isEmpty()) {
+        fingerprint = CodeModelSnapshot::fingerprint(contents);
+        snapshotPath = m_snapshotDirectory + fingerprint.toHex() + ".cms";
+
+        QFile snapshotFile(snapshotPath);
+        if (snapshotFile.open(QIODevice::ReadOnly)) {
+            m_dom = CodeModelSnapshot::load(&snapshotFile, m_codeModel, fingerprint);
+            if (!m_dom) {
+                // a truncated or corrupt snapshot leaves what it read so far
+                delete m_codeModel;
+                m_codeModel = new CodeModel;
+            }
+        }
+
+        if (m_dom) {
+            ReportHandler::debugSparse(QString("code model loaded from snapshot %1").arg(snapshotPath));
+        } else {
+            // Bring the last snapshot up to date, re-parsing only the
+            // headers that changed since.
+            CodeModelPartition partition(contents);
+            partitions = partition.fingerprints();
+
+            QFile latestFile(m_snapshotDirectory + "latest");
+            QString latestPath;
+            if (partition.isSelfContained() && latestFile.open(QIODevice::ReadOnly))
+                latestPath = m_snapshotDirectory + QString::fromLatin1(latestFile.readAll().trimmed());
+
+            QFile latestSnapshotFile(latestPath);
+            CodeModelPartition::FingerprintMap previous;
+            if (!latestPath.isEmpty() && latestSnapshotFile.open(QIODevice::ReadOnly))
+                m_dom = CodeModelSnapshot::load(&latestSnapshotFile, m_codeModel, QByteArray(), &previous);
+
+            if (m_dom && partition.update(m_dom, previous)) {
+                ReportHandler::debugSparse(QString("code model updated from snapshot %1").arg(latestPath));
+            } else if (latestSnapshotFile.isOpen()) {
+                // Neither a partly read snapshot nor one that failed to
+                // update may end up in the parsed model; the items are
+                // released with their model only.
+                m_dom = FileModelItem();
+                delete m_codeModel;
+                m_codeModel = new CodeModel;
+            }
+        }
+    }
+
+    CodeModel &model = *m_codeModel;
+    if (!m_dom) {
+        Control control;
+        Parser p(&control);
+        pool __pool;
 
-    TranslationUnitAST* ast = p.parse(contents, contents.size(), &__pool);
+        TranslationUnitAST* ast = p.parse(contents, contents.size(), &__pool);
 
-    CodeModel model;
-    Binder binder(&model, p.location());
-    m_dom = binder.run(ast);
+        Binder binder(&model, p.location());
+        m_dom = binder.run(ast);
+
+        const CodeModelNameTable *names = model.nameTable();
+        ReportHandler::debugSparse(QString("code model names: %1 unique names, %2 unique paths")
+                                   .arg(names->nameCount())
+                                   .arg(names->pathCount()));
+    }
+
+    if (!snapshotPath.isEmpty() && !partitions.isEmpty()) {
+        // "latest" may only name a complete snapshot, so it goes last
+        QBuffer snapshot;
+        snapshot.open(QIODevice::WriteOnly);
+        if (!CodeModelSnapshot::save(&snapshot, m_dom, fingerprint, partitions)
+            || !writeFileAtomically(snapshotPath, snapshot.data())
+            || !writeFileAtomically(m_snapshotDirectory + "latest", fingerprint.toHex() + ".cms")) {
+            ReportHandler::warning(QString("Couldn't write code model snapshot %1").arg(snapshotPath));
+        }
+    }
 
     pushScope(model_dynamic_cast<ScopeModelItem>(m_dom));
 
-    QHash<QString, ClassModelItem> typeMap = m_dom->classMap();
+    const QHash<QString, ClassModelItem> &typeMap = m_dom->classMap();
 
     // fix up QObject's in the type system..
     fixQObjectForScope(types, model_dynamic_cast<NamespaceModelItem>(m_dom));
@@ -365,7 +473,7 @@ bool AbstractMetaBuilder::build(QIODevice* input)
     ReportHandler::flush();
 
     // We need to know all global enums
-    QHash<QString, EnumModelItem> enumMap = m_dom->enumMap();
+    const QHash<QString, EnumModelItem> &enumMap = m_dom->enumMap();
     ReportHandler::setProgressReference(enumMap);
     foreach (EnumModelItem item, enumMap) {
         ReportHandler::progress("Generating enum model...");
@@ -377,7 +485,7 @@ bool AbstractMetaBuilder::build(QIODevice* input)
     }
     ReportHandler::flush();
 
-    QHash<QString, NamespaceModelItem> namespaceMap = m_dom->namespaceMap();
+    const QHash<QString, NamespaceModelItem> &namespaceMap = m_dom->namespaceMap();
     NamespaceList namespaceTypeValues = namespaceMap.values();
     qSort(namespaceTypeValues);
     NamespaceList::iterator nsit = std::unique(namespaceTypeValues.begin(), namespaceTypeValues.end());
@@ -388,21 +496,23 @@ bool AbstractMetaBuilder::build(QIODevice* input)
         ReportHandler::progress("Generating namespace model...");
         AbstractMetaClass *metaClass = traverseNamespace(item);
         if (metaClass)
-            m_metaClasses << metaClass;
+            addMetaClass(metaClass);
     }
     ReportHandler::flush();
 
     // Go through all typedefs to see if we have defined any
     // specific typedefs to be used as classes.
-    TypeAliasList typeAliases = m_dom->typeAliases();
+    const QHash<QString, TypeAliasModelItem> &typeAliases = m_dom->typeAliasMap();
     ReportHandler::setProgressReference(typeAliases);
-    foreach (TypeAliasModelItem typeAlias, typeAliases) {
+    foreach (const TypeAliasModelItem &typeAlias, typeAliases) {
         ReportHandler::progress("Resolving typedefs...");
         AbstractMetaClass* cls = traverseTypeAlias(typeAlias);
         addAbstractMetaClass(cls);
     }
     ReportHandler::flush();
 
+    // All enums are known by now; their values are figured out below
+    indexEnums();
     figureOutEnumValues();
 
     foreach (ClassModelItem item, typeValues)
@@ -412,7 +522,7 @@ bool AbstractMetaBuilder::build(QIODevice* input)
         traverseNamespaceMembers(item);
 
     // Global functions
-    foreach (FunctionModelItem func, m_dom->functions()) {
+    foreach (const FunctionModelItem &func, m_dom->functionMap()) {
         if (func->accessPolicy() != CodeModel::Public || func->name().startsWith("operator"))
             continue;
 
@@ -447,6 +557,8 @@ bool AbstractMetaBuilder::build(QIODevice* input)
     }
     ReportHandler::flush();
 
+    fixFunctionsByLevel();
+
     ReportHandler::setProgressReference(m_metaClasses);
     foreach (AbstractMetaClass* cls, m_metaClasses) {
         ReportHandler::progress("Detecting inconsistencies in class model...");
@@ -471,6 +583,9 @@ bool AbstractMetaBuilder::build(QIODevice* input)
     ReportHandler::flush();
 
     TypeEntryHash allEntries = types->allEntries();
+    QSet<const TypeEntry *> globalEnumEntries;
+    foreach (AbstractMetaEnum* metaEnum, m_enums)
+        globalEnumEntries << metaEnum->typeEntry();
     ReportHandler::progress("Detecting inconsistencies in typesystem...");
     foreach (QList<TypeEntry*> entries, allEntries) {
         foreach (TypeEntry* entry, entries) {
@@ -484,7 +599,7 @@ bool AbstractMetaBuilder::build(QIODevice* input)
                 && !entry->isContainer()
                 && !entry->isCustom()
                 && !entry->isVariant()
-                && !m_metaClasses.findClass(entry->qualifiedCppName())) {
+                && !findMetaClass(entry->qualifiedCppName())) {
                 ReportHandler::warning(QString("type '%1' is specified in typesystem, but not defined. This could potentially lead to compilation errors.")
                                     .arg(entry->qualifiedCppName()));
             } else if (entry->generateCode() && entry->type() == TypeEntry::FunctionType) {
@@ -504,18 +619,13 @@ bool AbstractMetaBuilder::build(QIODevice* input)
                 }
             } else if (entry->isEnum()) {
                 const QString name = ((EnumTypeEntry*) entry)->targetLangQualifier();
-                AbstractMetaClass* cls = m_metaClasses.findClass(name);
+                AbstractMetaClass* cls = findMetaClass(name);
 
                 bool enumFound = false;
                 if (cls) {
                     enumFound = cls->findEnum(entry->targetLangName());
                 } else { // Global enum
-                    foreach (AbstractMetaEnum* metaEnum, m_enums) {
-                        if (metaEnum->typeEntry() == entry) {
-                            enumFound = true;
-                            break;
-                        }
-                    }
+                    enumFound = globalEnumEntries.contains(entry);
                 }
                 if (!enumFound) {
                     entry->setCodeGeneration(TypeEntry::GenerateNothing);
@@ -571,6 +681,7 @@ bool AbstractMetaBuilder::build(QIODevice* input)
 
     // sort all classes topologically
     m_metaClasses = classesTopologicalSorted();
+    reindexMetaClasses();
 
     foreach (AbstractMetaClass* cls, m_metaClasses) {
 //         setupEquals(cls);
@@ -598,6 +709,16 @@ bool AbstractMetaBuilder::build(QIODevice* input)
         m_globalFunctions << metaFunc;
     }
 
+    indexEnums();
+
+    foreach (AbstractMetaClass* cls, m_metaClasses)
+        cls->freezeFunctionQueries();
+
+    ReportHandler::debugSparse(QString("translateType cache: %1 hits, %2 misses, %3 cached types")
+                               .arg(m_translatedTypeHits)
+                               .arg(m_translatedTypeMisses)
+                               .arg(m_translatedTypes.size()));
+
     std::puts("");
     return true;
 }
@@ -609,6 +730,109 @@ void AbstractMetaBuilder::setLogDirectory(const QString& logDir)
        m_logDirectory.append(QDir::separator());
 }
 
+void AbstractMetaBuilder::setThreadCount(int threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+void AbstractMetaBuilder::setSnapshotDirectory(const QString& snapshotDir)
+{
+    m_snapshotDirectory = snapshotDir;
+    if (!m_snapshotDirectory.isEmpty() && !m_snapshotDirectory.endsWith(QDir::separator()))
+       m_snapshotDirectory.append(QDir::separator());
+}
+
+void AbstractMetaBuilder::addMetaClass(AbstractMetaClass *metaClass)
+{
+    m_metaClasses << metaClass;
+
+    // Same precedence as AbstractMetaClassList::findClass(): the first
+    // class registered under a key is the one found by it.
+    QString cppName = metaClass->qualifiedCppName();
+    if (!m_classesByCppName.contains(cppName))
+        m_classesByCppName.insert(cppName, metaClass);
+    QString fullName = metaClass->fullName();
+    if (!m_classesByFullName.contains(fullName))
+        m_classesByFullName.insert(fullName, metaClass);
+    QString name = metaClass->name();
+    if (!m_classesByName.contains(name))
+        m_classesByName.insert(name, metaClass);
+    if (!m_classesByTypeEntry.contains(metaClass->typeEntry()))
+        m_classesByTypeEntry.insert(metaClass->typeEntry(), metaClass);
+}
+
+void AbstractMetaBuilder::reindexMetaClasses()
+{
+    AbstractMetaClassList classes = m_metaClasses;
+    m_metaClasses.clear();
+    m_classesByCppName.clear();
+    m_classesByFullName.clear();
+    m_classesByName.clear();
+    m_classesByTypeEntry.clear();
+    foreach (AbstractMetaClass *metaClass, classes)
+        addMetaClass(metaClass);
+}
+
+AbstractMetaClass *AbstractMetaBuilder::findMetaClass(const QString &name) const
+{
+    if (name.isEmpty())
+        return 0;
+
+    if (AbstractMetaClass *metaClass = m_classesByCppName.value(name))
+        return metaClass;
+    if (AbstractMetaClass *metaClass = m_classesByFullName.value(name))
+        return metaClass;
+    return m_classesByName.value(name);
+}
+
+AbstractMetaClass *AbstractMetaBuilder::findMetaClass(const TypeEntry *typeEntry) const
+{
+    return m_classesByTypeEntry.value(typeEntry);
+}
+
+void AbstractMetaBuilder::indexEnums()
+{
+    m_enumsByTypeEntry.clear();
+    m_enumValuesByName.clear();
+
+    // Global enums first, then the classes in their final order; the first
+    // enum or value registered under a key is the one found by it.
+    foreach (AbstractMetaEnum *metaEnum, m_globalEnums) {
+        if (!m_enumsByTypeEntry.contains(metaEnum->typeEntry()))
+            m_enumsByTypeEntry.insert(metaEnum->typeEntry(), metaEnum);
+    }
+    foreach (AbstractMetaClass *metaClass, m_metaClasses) {
+        QString prefix = metaClass->qualifiedCppName() + "::";
+        foreach (AbstractMetaEnum *metaEnum, metaClass->enums()) {
+            if (!m_enumsByTypeEntry.contains(metaEnum->typeEntry()))
+                m_enumsByTypeEntry.insert(metaEnum->typeEntry(), metaEnum);
+            foreach (AbstractMetaEnumValue *enumValue, metaEnum->values()) {
+                QString qualifiedName = prefix + enumValue->name();
+                if (!m_enumValuesByName.contains(qualifiedName))
+                    m_enumValuesByName.insert(qualifiedName, enumValue);
+                if (!m_enumValuesByName.contains(enumValue->name()))
+                    m_enumValuesByName.insert(enumValue->name(), enumValue);
+            }
+        }
+    }
+    foreach (AbstractMetaEnum *metaEnum, m_globalEnums) {
+        foreach (AbstractMetaEnumValue *enumValue, metaEnum->values()) {
+            if (!m_enumValuesByName.contains(enumValue->name()))
+                m_enumValuesByName.insert(enumValue->name(), enumValue);
+        }
+    }
+}
+
+AbstractMetaEnum *AbstractMetaBuilder::findEnum(const TypeEntry *typeEntry) const
+{
+    return m_enumsByTypeEntry.value(typeEntry);
+}
+
+AbstractMetaEnumValue *AbstractMetaBuilder::findEnumValue(const QString &name) const
+{
+    return m_enumValuesByName.value(name);
+}
+
 void AbstractMetaBuilder::addAbstractMetaClass(AbstractMetaClass *cls)
 {
     if (!cls)
@@ -618,10 +842,10 @@ void AbstractMetaBuilder::addAbstractMetaClass(AbstractMetaClass *cls)
     if (cls->typeEntry()->isContainer()) {
         m_templates << cls;
     } else {
-        m_metaClasses << cls;
+        addMetaClass(cls);
         if (cls->typeEntry()->designatedInterface()) {
             AbstractMetaClass* interface = cls->extractInterface();
-            m_metaClasses << interface;
+            addMetaClass(interface);
             ReportHandler::debugSparse(QString(" -> interface '%1'").arg(interface->name()));
         }
     }
@@ -644,6 +868,7 @@ AbstractMetaClass* AbstractMetaBuilder::traverseNamespace(NamespaceModelItem nam
 
     AbstractMetaClass* metaClass = createMetaClass();
     metaClass->setTypeEntry(type);
+    metaClass->cacheFunctionModifications();
 
     *metaClass += AbstractMetaAttributes::Public;
 
@@ -670,8 +895,7 @@ AbstractMetaClass* AbstractMetaBuilder::traverseNamespace(NamespaceModelItem nam
 
     // Go through all typedefs to see if we have defined any
     // specific typedefs to be used as classes.
-    TypeAliasList typeAliases = namespaceItem->typeAliases();
-    foreach (TypeAliasModelItem typeAlias, typeAliases) {
+    foreach (const TypeAliasModelItem &typeAlias, namespaceItem->typeAliasMap()) {
         AbstractMetaClass* cls = traverseTypeAlias(typeAlias);
         if (cls) {
             metaClass->addInnerClass(cls);
@@ -1049,6 +1273,7 @@ AbstractMetaClass* AbstractMetaBuilder::traverseTypeAlias(TypeAliasModelItem typ
     AbstractMetaClass *metaClass = createMetaClass();
     metaClass->setTypeAlias(true);
     metaClass->setTypeEntry(type);
+    metaClass->cacheFunctionModifications();
     metaClass->setBaseClassNames(QStringList() << typeAlias->type().qualifiedName().join("::"));
     *metaClass += AbstractMetaAttributes::Public;
 
@@ -1106,6 +1331,7 @@ AbstractMetaClass* AbstractMetaBuilder::traverseClass(ClassModelItem classItem)
 
     AbstractMetaClass* metaClass = createMetaClass();
     metaClass->setTypeEntry(type);
+    metaClass->cacheFunctionModifications();
     metaClass->setBaseClassNames(classItem->baseClasses());
     *metaClass += AbstractMetaAttributes::Public;
     if (type->stream())
@@ -1136,13 +1362,12 @@ AbstractMetaClass* AbstractMetaBuilder::traverseClass(ClassModelItem classItem)
 
     // Inner classes
     {
-        QList<ClassModelItem> innerClasses = classItem->classMap().values();
-        foreach (const ClassModelItem &ci, innerClasses) {
+        foreach (const ClassModelItem &ci, classItem->classMap()) {
             AbstractMetaClass *cl = traverseClass(ci);
             if (cl) {
                 cl->setEnclosingClass(metaClass);
                 metaClass->addInnerClass(cl);
-                m_metaClasses << cl;
+                addMetaClass(cl);
             }
         }
 
@@ -1150,8 +1375,7 @@ AbstractMetaClass* AbstractMetaBuilder::traverseClass(ClassModelItem classItem)
 
     // Go through all typedefs to see if we have defined any
     // specific typedefs to be used as classes.
-    TypeAliasList typeAliases = classItem->typeAliases();
-    foreach (TypeAliasModelItem typeAlias, typeAliases) {
+    foreach (const TypeAliasModelItem &typeAlias, classItem->typeAliasMap()) {
         AbstractMetaClass* cls = traverseTypeAlias(typeAlias);
         if (cls) {
             cls->setEnclosingClass(metaClass);
@@ -1169,6 +1393,86 @@ AbstractMetaClass* AbstractMetaBuilder::traverseClass(ClassModelItem classItem)
     return metaClass;
 }
 
+class FixFunctionsTask : public QRunnable
+{
+public:
+    FixFunctionsTask(const AbstractMetaClassList &classes, int first, int stride)
+        : m_classes(classes), m_first(first), m_stride(stride) {}
+
+    void run()
+    {
+        for (int i = m_first; i < m_classes.size(); i += m_stride)
+            m_classes.at(i)->fixFunctions();
+    }
+
+private:
+    AbstractMetaClassList m_classes;
+    int m_first;
+    int m_stride;
+};
+
+void AbstractMetaBuilder::fixFunctionsByLevel()
+{
+    // AbstractMetaClass::fixFunctions() fixes the base class first, so the
+    // classes are taken in Kahn order of the base class edges: every level
+    // holds the classes whose base classes are in the levels before, and
+    // its classes don't depend on each other. Interfaces are read without
+    // being fixed first, depending on the class order, so the classes
+    // that have some in their hierarchy are left to the caller, as are
+    // base class cycles.
+    QHash<AbstractMetaClass *, bool> independent;
+    QHash<AbstractMetaClass *, AbstractMetaClassList> derivedClasses;
+    AbstractMetaClassList level;
+    foreach (AbstractMetaClass *cls, m_metaClasses) {
+        AbstractMetaClassList chain;
+        AbstractMetaClass *c = cls;
+        for (; c && !independent.contains(c) && !chain.contains(c); c = c->baseClass())
+            chain.prepend(c);
+
+        // c is 0 at the root, or was seen before, or closes a cycle
+        bool levelled = c ? independent.value(c, false) : true;
+        foreach (AbstractMetaClass *link, chain) {
+            levelled = levelled && !link->isInterface() && link->interfaces().isEmpty();
+            independent.insert(link, levelled);
+            if (!levelled)
+                continue;
+            if (link->baseClass())
+                derivedClasses[link->baseClass()] << link;
+            else
+                level << link;
+        }
+    }
+
+    int threadCount = m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(qMax(threadCount, 1));
+
+    QTime time;
+    for (int depth = 0; !level.isEmpty(); ++depth) {
+        time.start();
+
+        int levelThreads = qMin(threadCount, level.size());
+        if (levelThreads > 1) {
+            foreach (AbstractMetaClass *cls, level)
+                cls->prepareFixFunctions();
+            for (int i = 0; i < levelThreads; ++i)
+                threadPool.start(new FixFunctionsTask(level, i, levelThreads));
+            threadPool.waitForDone();
+        } else {
+            foreach (AbstractMetaClass *cls, level)
+                cls->fixFunctions();
+        }
+
+        ReportHandler::debugSparse(QString("fixed functions of inheritance level %1: %2 classes in %3 ms")
+                                   .arg(depth).arg(level.size()).arg(time.elapsed()));
+
+        AbstractMetaClassList nextLevel;
+        foreach (AbstractMetaClass *cls, level)
+            nextLevel += derivedClasses.value(cls);
+        level = nextLevel;
+    }
+}
+
 void AbstractMetaBuilder::traverseScopeMembers(ScopeModelItem item, AbstractMetaClass* metaClass)
 {
     // Classes/Namespace members
@@ -1193,7 +1497,7 @@ AbstractMetaClass* AbstractMetaBuilder::currentTraversedClass(ScopeModelItem ite
     if (m_currentClass)
         fullClassName = stripTemplateArgs(m_currentClass->typeEntry()->qualifiedCppName()) + "::" + fullClassName;
 
-    AbstractMetaClass* metaClass = m_metaClasses.findClass(fullClassName);
+    AbstractMetaClass* metaClass = findMetaClass(fullClassName);
     if (!metaClass)
         metaClass = m_templates.findClass(fullClassName);
     return metaClass;
@@ -1292,7 +1596,7 @@ AbstractMetaField* AbstractMetaBuilder::traverseField(VariableModelItem field, c
 
 void AbstractMetaBuilder::traverseFields(ScopeModelItem scope_item, AbstractMetaClass *metaClass)
 {
-    foreach (VariableModelItem field, scope_item->variables()) {
+    foreach (const VariableModelItem &field, scope_item->variableMap()) {
         AbstractMetaField* metaField = traverseField(field, metaClass);
 
         if (metaField && !metaField->isModifiedRemoved()) {
@@ -1390,14 +1694,14 @@ static bool _fixFunctionModelItemType(TypeInfo& type, const AbstractMetaClass* m
     return true;
 }
 
-static bool _fixFunctionModelItemTypes(FunctionModelItem& function, const AbstractMetaClass* metaClass)
+static bool _fixFunctionModelItemTypes(const FunctionModelItem& function, const AbstractMetaClass* metaClass)
 {
     TypeInfo functionType = function->type();
     bool templateTypeFixed = _fixFunctionModelItemType(functionType, metaClass);
     if (templateTypeFixed)
         function->setType(functionType);
 
-    ArgumentList arguments = function->arguments();
+    const ArgumentList &arguments = function->arguments();
     for (int i = 0; i < arguments.size(); ++i) {
         ArgumentModelItem arg = arguments.at(i);
         TypeInfo type = arg->type();
@@ -1411,7 +1715,7 @@ static bool _fixFunctionModelItemTypes(FunctionModelItem& function, const Abstra
 
 void AbstractMetaBuilder::traverseFunctions(ScopeModelItem scopeItem, AbstractMetaClass* metaClass)
 {
-    foreach (FunctionModelItem function, scopeItem->functions()) {
+    foreach (const FunctionModelItem &function, scopeItem->functionMap()) {
 
         // This fixes method's arguments and return types that are templates
         // but the template variable wasn't declared in the C++ header.
@@ -1594,7 +1898,7 @@ bool AbstractMetaBuilder::setupInheritance(AbstractMetaClass *metaClass)
             }
 
             if (!templ)
-                templ = m_metaClasses.findClass(baseName);
+                templ = findMetaClass(baseName);
 
             if (templ) {
                 setupInheritance(templ);
@@ -1633,7 +1937,7 @@ bool AbstractMetaBuilder::setupInheritance(AbstractMetaClass *metaClass)
     }
 
     if (primary >= 0) {
-        AbstractMetaClass* baseClass = m_metaClasses.findClass(baseClasses.at(primary));
+        AbstractMetaClass* baseClass = findMetaClass(baseClasses.at(primary));
         if (!baseClass) {
             ReportHandler::warning(QString("unknown baseclass for '%1': '%2'")
                                    .arg(metaClass->name())
@@ -1648,7 +1952,7 @@ bool AbstractMetaBuilder::setupInheritance(AbstractMetaClass *metaClass)
             continue;
 
         if (i != primary) {
-            AbstractMetaClass* baseClass = m_metaClasses.findClass(baseClasses.at(i));
+            AbstractMetaClass* baseClass = findMetaClass(baseClasses.at(i));
             if (!baseClass) {
                 ReportHandler::warning(QString("class not found for setup inheritance '%1'").arg(baseClasses.at(i)));
                 return false;
@@ -1657,7 +1961,7 @@ bool AbstractMetaBuilder::setupInheritance(AbstractMetaClass *metaClass)
             setupInheritance(baseClass);
 
             QString interfaceName = baseClass->isInterface() ? InterfaceTypeEntry::interfaceName(baseClass->name()) : baseClass->name();
-            AbstractMetaClass* iface = m_metaClasses.findClass(interfaceName);
+            AbstractMetaClass* iface = findMetaClass(interfaceName);
             if (!iface) {
                 ReportHandler::warning(QString("unknown interface for '%1': '%2'")
                                        .arg(metaClass->name())
@@ -1677,9 +1981,9 @@ bool AbstractMetaBuilder::setupInheritance(AbstractMetaClass *metaClass)
 
 void AbstractMetaBuilder::traverseEnums(ScopeModelItem scopeItem, AbstractMetaClass* metaClass, const QStringList &enumsDeclarations)
 {
-    EnumList enums = scopeItem->enums();
-    foreach (EnumModelItem enumItem, enums) {
-        AbstractMetaEnum* metaEnum = traverseEnum(enumItem, metaClass, QSet<QString>::fromList(enumsDeclarations));
+    QSet<QString> declarations = QSet<QString>::fromList(enumsDeclarations);
+    foreach (const EnumModelItem &enumItem, scopeItem->enumMap()) {
+        AbstractMetaEnum* metaEnum = traverseEnum(enumItem, metaClass, declarations);
         if (metaEnum) {
             metaClass->addEnum(metaEnum);
             metaEnum->setEnclosingClass(metaClass);
@@ -2051,9 +2355,179 @@ static const TypeEntry* findTypeEntryUsingContext(const AbstractMetaClass* metaC
     return type;
 }
 
+// A copy that owns its instantiations, as the types made by translateType().
+AbstractMetaType *AbstractMetaBuilder::cloneType(const AbstractMetaType *type)
+{
+    AbstractMetaType *clone = createMetaType();
+    clone->setTypeUsagePattern(type->typeUsagePattern());
+    clone->setConstant(type->isConstant());
+    clone->setReference(type->isReference());
+    clone->setIndirections(type->indirections());
+    clone->setArrayElementCount(type->arrayElementCount());
+    clone->setOriginalTypeDescription(type->originalTypeDescription());
+    clone->setTypeEntry(type->typeEntry());
+
+    if (type->hasInstantiations()) {
+        AbstractMetaTypeList instantiations;
+        foreach (const AbstractMetaType *instantiation, type->instantiations())
+            instantiations << cloneType(instantiation);
+        clone->setInstantiations(instantiations, true);
+    }
+
+    if (type->arrayElementType())
+        clone->setArrayElementType(cloneType(type->arrayElementType()));
+
+    return clone;
+}
+
+static bool sameTypeInfo(const TypeInfo &a, const TypeInfo &b)
+{
+    if (a.isConstant() != b.isConstant()
+        || a.isVolatile() != b.isVolatile()
+        || a.isReference() != b.isReference()
+        || a.isFunctionPointer() != b.isFunctionPointer()
+        || a.indirections() != b.indirections()
+        || a.qualifiedName() != b.qualifiedName()
+        || a.arrayElements() != b.arrayElements()
+        || a.arguments().size() != b.arguments().size())
+        return false;
+
+    for (int i = 0; i < a.arguments().size(); ++i) {
+        if (!sameTypeInfo(a.arguments().at(i), b.arguments().at(i)))
+            return false;
+    }
+    return true;
+}
+
+bool AbstractMetaBuilder::TranslatedTypeKey::operator==(const TranslatedTypeKey &other) const
+{
+    return resolveType == other.resolveType
+           && resolveScope == other.resolveScope
+           && scope == other.scope
+           && scopeDepth == other.scopeDepth
+           && currentClass == other.currentClass
+           && classCount == other.classCount
+           && sameTypeInfo(type, other.type);
+}
+
+uint qHash(const AbstractMetaBuilder::TranslatedTypeKey &key)
+{
+    uint h = qHash(key.scope) ^ qHash(key.currentClass) ^ (key.classCount << 8);
+    foreach (const QString &name, key.type.qualifiedName())
+        h = 31 * h + qHash(name);
+    return h ^ (key.type.indirections() << 4) ^ (uint(key.type.isReference()) << 2)
+           ^ (uint(key.type.isConstant()) << 1) ^ uint(key.resolveType) ^ (uint(key.resolveScope) << 3);
+}
+
+static void collectUsedTypes(const AbstractMetaType *type, QSet<const TypeEntry *> *usedTypes)
+{
+    if (type->arrayElementType()) {
+        collectUsedTypes(type->arrayElementType(), usedTypes);
+        return;
+    }
+
+    usedTypes->insert(type->typeEntry());
+    foreach (const AbstractMetaType *instantiation, type->instantiations())
+        collectUsedTypes(instantiation, usedTypes);
+}
+
+// translateType() results kept at most
+static const int MaxTranslatedTypes = 4096;
+
+// The cached translation for the key, if the type database has no new
+// entries for the names it looked up; a stale one is dropped
+AbstractMetaBuilder::TranslatedType *AbstractMetaBuilder::findTranslatedType(const TranslatedTypeKey &key)
+{
+    QHash<TranslatedTypeKey, TranslatedType>::iterator it = m_translatedTypes.find(key);
+    if (it == m_translatedTypes.end())
+        return 0;
+
+    TypeDatabase *typeDb = TypeDatabase::instance();
+    foreach (const QString &lookupKey, it->lookupKeys) {
+        if (typeDb->typeLookupRevision(lookupKey) > it->revision) {
+            delete it->type;
+            m_translatedTypes.erase(it);
+            return 0;
+        }
+    }
+    return &it.value();
+}
+
+void AbstractMetaBuilder::clearTranslatedTypes()
+{
+    foreach (const TranslatedType &translated, m_translatedTypes)
+        delete translated.type;
+    m_translatedTypes.clear();
+}
+
 AbstractMetaType* AbstractMetaBuilder::translateType(const TypeInfo& _typei, bool *ok, bool resolveType, bool resolveScope)
 {
     Q_ASSERT(ok);
+
+    // The result depends on the scopes being traversed and on the type
+    // database; if it depends on the class being traversed, also on the
+    // classes known so far (for the base classes of the current one).
+    TranslatedTypeKey key;
+    key.type = _typei;
+    key.resolveType = resolveType;
+    key.resolveScope = resolveScope;
+    key.scope = m_scopes.isEmpty() ? 0 : m_scopes.last().data();
+    key.scopeDepth = m_scopes.size();
+    key.currentClass = 0;
+    key.classCount = -1;
+
+    const TranslatedType *cached = findTranslatedType(key);
+    if (!cached) {
+        key.currentClass = m_currentClass;
+        key.classCount = m_metaClasses.size();
+        cached = findTranslatedType(key);
+    }
+    if (cached) {
+        ++m_translatedTypeHits;
+        m_translationUsesClass |= cached->usesClass;
+        m_translationLookupKeys << cached->lookupKeys;
+        *ok = cached->ok;
+        if (!cached->type)
+            return 0;
+        collectUsedTypes(cached->type, &m_usedTypes);
+        return cloneType(cached->type);
+    }
+    ++m_translatedTypeMisses;
+
+    // failures that were reported are translated again, to report them again
+    bool outerUsesClass = m_translationUsesClass;
+    QStringList outerLookupKeys = m_translationLookupKeys;
+    m_translationUsesClass = false;
+    m_translationLookupKeys.clear();
+    uint revision = TypeDatabase::instance()->revision();
+    int reported = ReportHandler::warningCount() + ReportHandler::suppressedCount();
+    AbstractMetaType *type = translateTypeUncached(_typei, ok, resolveType, resolveScope);
+    m_translationLookupKeys.removeDuplicates();
+    if (reported == ReportHandler::warningCount() + ReportHandler::suppressedCount()) {
+        // the keys of the classes traversed before go stale, so the
+        // cache is bounded rather than left to grow with them
+        if (m_translatedTypes.size() >= MaxTranslatedTypes)
+            clearTranslatedTypes();
+
+        TranslatedType translated;
+        translated.type = type ? cloneType(type) : 0;
+        translated.ok = *ok;
+        translated.usesClass = m_translationUsesClass;
+        translated.revision = revision;
+        translated.lookupKeys = m_translationLookupKeys;
+        if (!translated.usesClass) {
+            key.currentClass = 0;
+            key.classCount = -1;
+        }
+        m_translatedTypes.insert(key, translated);
+    }
+    m_translationUsesClass |= outerUsesClass;
+    m_translationLookupKeys = outerLookupKeys + m_translationLookupKeys;
+    return type;
+}
+
+AbstractMetaType* AbstractMetaBuilder::translateTypeUncached(const TypeInfo& _typei, bool *ok, bool resolveType, bool resolveScope)
+{
     *ok = true;
 
     // 1. Test the type info without resolving typedefs in case this is present in the
@@ -2078,7 +2552,7 @@ AbstractMetaType* AbstractMetaBuilder::translateType(const TypeInfo& _typei, boo
         int i = m_scopes.size() - 1;
         while (i >= 0) {
             typei = TypeInfo::resolveType(_typei, m_scopes.at(i--)->toItem());
-            if (typei.qualifiedName().join("::") != _typei.qualifiedName().join("::"))
+            if (typei.qualifiedName() != _typei.qualifiedName())
                 break;
         }
 
@@ -2154,11 +2628,19 @@ AbstractMetaType* AbstractMetaBuilder::translateType(const TypeInfo& _typei, boo
     if (qualifiedName == "QFlags")
         qualifiedName = typeInfo.toString();
 
+    // all the lookups below are by names with the same lookup key
+    m_translationLookupKeys << TypeDatabase::typeLookupKey(qualifiedName);
+
     const TypeEntry *type = 0;
     // 5. Try to find the type
 
-    // 5.1 - Try first using the current scope
-    if (m_currentClass) {
+    // 5.1 - Try first using the current scope; only nested type names
+    //       can be found this way, so their translation depends on the
+    //       current class, also when there is none
+    bool nestedName = TypeDatabase::instance()->isNestedTypeName(qualifiedName);
+    if (nestedName)
+        m_translationUsesClass = true;
+    if (m_currentClass && nestedName) {
         type = findTypeEntryUsingContext(m_currentClass, qualifiedName);
 
         // 5.1.1 - Try using the class parents' scopes
@@ -2183,6 +2665,11 @@ AbstractMetaType* AbstractMetaBuilder::translateType(const TypeInfo& _typei, boo
     if (!type)
         type = TypeDatabase::instance()->findContainerType(name);
 
+    // What is not found by now depends on the class: steps 8 and 9 only
+    // search it, and the failure is only valid without it
+    if (!type)
+        m_translationUsesClass = true;
+
     // 8. No? Check if the current class is a template and this type is one
     //    of the parameters.
     if (!type && m_currentClass) {
@@ -2282,21 +2769,14 @@ int AbstractMetaBuilder::findOutValueFromString(const QString& stringValue, bool
         return 0;
     }
 
-    AbstractMetaEnumValue* enumValue = m_metaClasses.findEnumValue(stringValue);
+    // class values first, then the global ones
+    AbstractMetaEnumValue* enumValue = findEnumValue(stringValue);
     if (enumValue) {
         ok = true;
         return enumValue->value();
     }
 
-    foreach (AbstractMetaEnum* metaEnum, m_globalEnums) {
-        foreach (AbstractMetaEnumValue* ev, metaEnum->values()) {
-            if (ev->name() == stringValue) {
-                ok = true;
-                return ev->value();
-            }
-        }
-    }
-
+    ReportHandler::warning(QString("no matching enum '%1'").arg(stringValue));
     ok = false;
     return 0;
 }
@@ -2397,11 +2877,8 @@ bool AbstractMetaBuilder::isQObject(const QString& qualifiedName)
 
     if (!classItem) {
         QStringList names = qualifiedName.split(QLatin1String("::"));
-        NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(m_dom);
-        for (int i = 0; i < names.size() - 1 && ns; ++i)
-            ns = ns->namespaceMap().value(names.at(i));
-        if (ns && names.size() >= 2)
-            classItem = ns->findClass(names.at(names.size() - 1));
+        if (names.size() >= 2)
+            classItem = model_dynamic_cast<ClassModelItem>(m_dom->model()->findItem(names, m_dom->toItem()));
     }
 
     bool isqobject = classItem && classItem->extendsClass("QObject");
@@ -2430,7 +2907,7 @@ AbstractMetaClassList AbstractMetaBuilder::getBaseClasses(const AbstractMetaClas
 {
     AbstractMetaClassList baseClasses;
     foreach (const QString& parent, metaClass->baseClassNames()) {
-        AbstractMetaClass* cls = m_metaClasses.findClass(parent);
+        AbstractMetaClass* cls = findMetaClass(parent);
         if (cls)
             baseClasses << cls;
     }
@@ -2745,7 +3222,7 @@ void AbstractMetaBuilder::setupExternalConversion(AbstractMetaClass* cls) {
     foreach (AbstractMetaFunction* func, convOps) {
         if (func->isModifiedRemoved())
             continue;
-        AbstractMetaClass* metaClass = m_metaClasses.findClass(func->type()->typeEntry());
+        AbstractMetaClass* metaClass = findMetaClass(func->type()->typeEntry());
         if (!metaClass)
             continue;
         metaClass->addExternalConversionOperator(func);
@@ -95,6 +95,20 @@ public:
 
     bool build(QIODevice* input);
     void setLogDirectory(const QString& logDir);
+    /**
+     *   Enables reusing code models across runs: the bound model of every
+     *   preprocessed input is stored in \p snapshotDir, keyed by a
+     *   fingerprint of that input, and reloaded instead of being parsed
+     *   again when the same input is seen later.
+     */
+    void setSnapshotDirectory(const QString& snapshotDir);
+    /**
+     *   Number of threads fixing the functions of the classes of each
+     *   inheritance level; 0 uses one per core. The default, 1, does it
+     *   on the calling thread. The classes are traversed sequentially
+     *   whatever the count.
+     */
+    void setThreadCount(int threadCount);
 
     void figureOutEnumValuesForClass(AbstractMetaClass *metaClass, QSet<AbstractMetaClass *> *classes);
     int figureOutEnumValue(const QString &name, int value, AbstractMetaEnum *meta_enum, AbstractMetaFunction *metaFunction = 0);
@@ -164,6 +178,16 @@ public:
         return m_globalEnums;
     }
 
+    /**
+    *   Enum lookups answered from an index built once all enums are
+    *   traversed, and again at the end of build() for the final order.
+    *   Enum values are found by their name qualified with the enclosing
+    *   class ("Class::Value") or by their bare name, in which case the
+    *   first class declaring it wins, then the global enums.
+    */
+    AbstractMetaEnum *findEnum(const TypeEntry *typeEntry) const;
+    AbstractMetaEnumValue *findEnumValue(const QString &name) const;
+
     AbstractMetaClassList getBaseClasses(const AbstractMetaClass* metaClass) const;
     bool ancestorHasPrivateCopyConstructor(const AbstractMetaClass* metaClass) const;
 
@@ -229,8 +253,22 @@ protected:
     }
 
     FileModelItem m_dom;
+    // owns the items of m_dom when it was built by build()
+    CodeModel *m_codeModel;
 
 private:
+    void fixFunctionsByLevel();
+
+    void addMetaClass(AbstractMetaClass *metaClass);
+    void reindexMetaClasses();
+    AbstractMetaClass *findMetaClass(const QString &name) const;
+    AbstractMetaClass *findMetaClass(const TypeEntry *typeEntry) const;
+
+    void indexEnums();
+
+    AbstractMetaType *translateTypeUncached(const TypeInfo &type, bool *ok, bool resolveType, bool resolveScope);
+    AbstractMetaType *cloneType(const AbstractMetaType *type);
+
     void sortLists();
     AbstractMetaArgumentList reverseList(const AbstractMetaArgumentList& list);
     void setInclude(TypeEntry* te, const QString& fileName) const;
@@ -239,6 +277,13 @@ private:
 
     AbstractMetaClassList m_metaClasses;
     AbstractMetaClassList m_templates;
+
+    // m_metaClasses indexed by the keys AbstractMetaClassList::findClass()
+    // tries, first class wins; kept in sync by addMetaClass()
+    QHash<QString, AbstractMetaClass *> m_classesByCppName;
+    QHash<QString, AbstractMetaClass *> m_classesByFullName;
+    QHash<QString, AbstractMetaClass *> m_classesByName;
+    QHash<const TypeEntry *, AbstractMetaClass *> m_classesByTypeEntry;
     AbstractMetaFunctionList m_globalFunctions;
     AbstractMetaEnumList m_globalEnums;
 
@@ -251,6 +296,10 @@ private:
 
     QList<AbstractMetaEnum *> m_enums;
 
+    // filled by indexEnums() once the meta model is complete
+    QHash<const TypeEntry *, AbstractMetaEnum *> m_enumsByTypeEntry;
+    QHash<QString, AbstractMetaEnumValue *> m_enumValuesByName;
+
     QList<QPair<AbstractMetaArgument *, AbstractMetaFunction *> > m_enumDefaultArguments;
 
     QHash<QString, AbstractMetaEnumValue *> m_enumValues;
@@ -265,7 +314,49 @@ private:
     QSet<QString> m_qmetatypeDeclaredTypenames;
 
     QString m_logDirectory;
+    QString m_snapshotDirectory;
     QFileInfo m_globalHeader;
+
+    int m_threadCount;
+
+    // translateType() results by type and scope, valid as long as the type
+    // database has no new entries for the names they looked up; callers
+    // get copies of the cached prototypes
+    struct TranslatedTypeKey
+    {
+        TypeInfo type;
+        bool resolveType;
+        bool resolveScope;
+        // the innermost scope, scopes being pushed nested in each other
+        const void *scope;
+        int scopeDepth;
+        // 0 and -1 when the translation did not depend on the current class
+        const AbstractMetaClass *currentClass;
+        int classCount;
+
+        bool operator==(const TranslatedTypeKey &other) const;
+    };
+    friend uint qHash(const TranslatedTypeKey &key);
+
+    struct TranslatedType
+    {
+        AbstractMetaType *type;
+        bool ok;
+        bool usesClass;
+        // TypeDatabase::revision() when translated, and the lookup keys
+        // of the names looked up
+        uint revision;
+        QStringList lookupKeys;
+    };
+    TranslatedType *findTranslatedType(const TranslatedTypeKey &key);
+    void clearTranslatedTypes();
+    QHash<TranslatedTypeKey, TranslatedType> m_translatedTypes;
+    int m_translatedTypeHits;
+    int m_translatedTypeMisses;
+    // set by translateTypeUncached() when the result depends on m_currentClass
+    bool m_translationUsesClass;
+    // the lookup keys of the names looked up by translateTypeUncached()
+    QStringList m_translationLookupKeys;
 };
 
 #endif // ABSTRACTMETBUILDER_H
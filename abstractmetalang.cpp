@@ -775,15 +775,7 @@ FunctionModificationList AbstractMetaFunction::modifications(const AbstractMetaC
     if (!implementor)
         return TypeDatabase::instance()->functionModifications(minimalSignature());
 
-    FunctionModificationList mods;
-    while (implementor) {
-        mods += implementor->typeEntry()->functionModifications(minimalSignature());
-        if ((implementor == implementor->baseClass()) ||
-            (implementor == implementingClass() && (mods.size() > 0)))
-                break;
-        implementor = implementor->baseClass();
-    }
-    return mods;
+    return implementor->functionModifications(this);
 }
 
 bool AbstractMetaFunction::hasModifications(const AbstractMetaClass *implementor) const
@@ -1222,7 +1214,7 @@ AbstractMetaFunctionList AbstractMetaClass::implicitConversions() const
         return AbstractMetaFunctionList();
 
     AbstractMetaFunctionList returned;
-    AbstractMetaFunctionList list = queryFunctions(Constructors);
+    AbstractMetaFunctionList list = queryFunctions<Constructors>();
     list.append(externalConversionOperators());
 
     foreach (AbstractMetaFunction *f, list) {
@@ -1239,7 +1231,7 @@ AbstractMetaFunctionList AbstractMetaClass::implicitConversions() const
 
 AbstractMetaFunctionList AbstractMetaClass::operatorOverloads(uint query) const
 {
-    AbstractMetaFunctionList list = queryFunctions(OperatorOverloads | Visible);
+    AbstractMetaFunctionList list = queryFunctions<OperatorOverloads | Visible>();
     AbstractMetaFunctionList returned;
     foreach (AbstractMetaFunction *f, list) {
         if (((query & ArithmeticOp) && f->isArithmeticOperator())
@@ -1335,17 +1327,17 @@ bool AbstractMetaClass::hasConversionOperatorOverload() const
 AbstractMetaFunctionList AbstractMetaClass::functionsInShellClass() const
 {
     // Only functions and only protected and public functions
-    int default_flags = NormalFunctions | Visible | WasVisible | NotRemovedFromShell;
+    const uint default_flags = NormalFunctions | Visible | WasVisible | NotRemovedFromShell;
 
     // All virtual functions
-    AbstractMetaFunctionList returned = queryFunctions(VirtualFunctions | default_flags);
+    AbstractMetaFunctionList returned = queryFunctions<VirtualFunctions | default_flags>();
 
     // All functions explicitly set to be implemented by the shell class
     // (mainly superclass functions that are hidden by other declarations)
-    returned += queryFunctions(ForcedShellFunctions | default_flags);
+    returned += queryFunctions<ForcedShellFunctions | default_flags>();
 
     // All functions explicitly set to be virtual slots
-    returned += queryFunctions(VirtualSlots | default_flags);
+    returned += queryFunctions<VirtualSlots | default_flags>();
 
     return returned;
 }
@@ -1357,23 +1349,25 @@ AbstractMetaFunctionList AbstractMetaClass::functionsInShellClass() const
  */
 AbstractMetaFunctionList AbstractMetaClass::publicOverrideFunctions() const
 {
-    return queryFunctions(NormalFunctions | WasProtected | FinalInCppFunctions | NotRemovedFromTargetLang)
-           + queryFunctions(Signals | WasProtected | FinalInCppFunctions | NotRemovedFromTargetLang);
+    return queryFunctions<NormalFunctions | WasProtected | FinalInCppFunctions | NotRemovedFromTargetLang>()
+           + queryFunctions<Signals | WasProtected | FinalInCppFunctions | NotRemovedFromTargetLang>();
 }
 
 AbstractMetaFunctionList AbstractMetaClass::virtualOverrideFunctions() const
 {
-    return queryFunctions(NormalFunctions | NonEmptyFunctions | Visible | VirtualInCppFunctions | NotRemovedFromShell) +
-           queryFunctions(Signals | NonEmptyFunctions | Visible | VirtualInCppFunctions | NotRemovedFromShell);
+    return queryFunctions<NormalFunctions | NonEmptyFunctions | Visible | VirtualInCppFunctions | NotRemovedFromShell>() +
+           queryFunctions<Signals | NonEmptyFunctions | Visible | VirtualInCppFunctions | NotRemovedFromShell>();
 }
 
 void AbstractMetaClass::sortFunctions()
 {
+    unfreezeFunctionQueries();
     qSort(m_functions.begin(), m_functions.end(), function_sorter);
 }
 
 void AbstractMetaClass::setFunctions(const AbstractMetaFunctionList &functions)
 {
+    unfreezeFunctionQueries();
     m_functions = functions;
 
     // Functions must be sorted by name before next loop
@@ -1438,6 +1432,7 @@ bool AbstractMetaClass::hasDefaultToStringFunction() const
 void AbstractMetaClass::addFunction(AbstractMetaFunction *function)
 {
     Q_ASSERT(!function->signature().startsWith("("));
+    unfreezeFunctionQueries();
     function->setOwnerClass(this);
 
     if (!function->isDestructor())
@@ -1470,8 +1465,14 @@ QString AbstractMetaClass::name() const
     return QString(m_typeEntry->targetLangName()).split("::").last();
 }
 
+// Changes whenever a class gets another base class, which changes where
+// the walk of collectFunctionModifications() goes
+static uint classHierarchyRevision = 0;
+
 void AbstractMetaClass::setBaseClass(AbstractMetaClass *baseClass)
 {
+    if (m_baseClass != baseClass)
+        ++classHierarchyRevision;
     m_baseClass = baseClass;
     if (baseClass)
         m_isPolymorphic |= baseClass->isPolymorphic();
@@ -1714,12 +1715,12 @@ const AbstractMetaFunction *AbstractMetaField::getter() const
 
 bool AbstractMetaClass::hasConstructors() const
 {
-    return queryFunctions(Constructors).size();
+    return queryFunctions<Constructors>().size();
 }
 
 bool AbstractMetaClass::hasCopyConstructor() const
 {
-    foreach (const AbstractMetaFunction* ctor, queryFunctions(Constructors)) {
+    foreach (const AbstractMetaFunction* ctor, queryFunctions<Constructors>()) {
         if (ctor->isCopyConstructor())
             return true;
     }
@@ -1728,7 +1729,7 @@ bool AbstractMetaClass::hasCopyConstructor() const
 
 bool AbstractMetaClass::hasPrivateCopyConstructor() const
 {
-    foreach (const AbstractMetaFunction* ctor, queryFunctions(Constructors)) {
+    foreach (const AbstractMetaFunction* ctor, queryFunctions<Constructors>()) {
         if (ctor->isCopyConstructor() && ctor->isPrivate())
             return true;
     }
@@ -1794,117 +1795,149 @@ bool AbstractMetaClass::hasFunction(const AbstractMetaFunction *f) const
     return functions_contains(m_functions, f);
 }
 
+const uint AbstractMetaClass::RuntimeQuery;
+
 /* Goes through the list of functions and returns a list of all
    functions matching all of the criteria in \a query.
  */
 
 AbstractMetaFunctionList AbstractMetaClass::queryFunctions(uint query) const
 {
+    if (m_functionQueriesFrozen)
+        return queryFrozenFunctions(query);
+
     AbstractMetaFunctionList functions;
 
     foreach (AbstractMetaFunction *f, m_functions) {
+        if (functionMatchesQuery<RuntimeQuery>(f, query))
+            functions << f;
+    }
 
-        if ((query & VirtualSlots) && !f->isVirtualSlot())
-            continue;
-
-        if ((query & NotRemovedFromTargetLang) && f->isRemovedFrom(f->implementingClass(), TypeSystem::TargetLangCode))
-            continue;
-
-        if ((query & NotRemovedFromTargetLang) && !f->isFinal() && f->isRemovedFrom(f->declaringClass(), TypeSystem::TargetLangCode))
-            continue;
-
-        if ((query & NotRemovedFromShell) && f->isRemovedFrom(f->implementingClass(), TypeSystem::ShellCode))
-            continue;
-
-        if ((query & NotRemovedFromShell) && !f->isFinal() && f->isRemovedFrom(f->declaringClass(), TypeSystem::ShellCode))
-            continue;
-
-        if ((query & Visible) && f->isPrivate())
-            continue;
-
-        if ((query & VirtualInTargetLangFunctions) && f->isFinalInTargetLang())
-            continue;
-
-        if ((query & Invisible) && !f->isPrivate())
-            continue;
-
-        if ((query & Empty) && !f->isEmptyFunction())
-            continue;
-
-        if ((query & WasPublic) && !f->wasPublic())
-            continue;
-
-        if ((query & WasVisible) && f->wasPrivate())
-            continue;
-
-        if ((query & WasProtected) && !f->wasProtected())
-            continue;
+    return functions;
+}
 
-        if ((query & ClassImplements) && f->ownerClass() != f->implementingClass())
-            continue;
 
-        if ((query & Inconsistent) && (f->isFinalInTargetLang() || !f->isFinalInCpp() || f->isStatic()))
-            continue;
+// Set in a function query mask when the function is not a constructor; a
+// query without the Constructors option requires it.
+static const uint NotAConstructor = 0x80000000;
 
-        if ((query & FinalInTargetLangFunctions) && !f->isFinalInTargetLang())
-            continue;
+/*!
+ * Returns the options of a query \a f passes the filter of, with the bits
+ * of options that filter nothing set. Every option is tested on its own
+ * with functionMatchesQuery(), so both filters share the same checks.
+ */
+uint AbstractMetaClass::functionQueryMask(const AbstractMetaFunction *f)
+{
+    // Without any option only the constructors are filtered out
+    bool notAConstructor = functionMatchesQuery<RuntimeQuery>(f, 0);
+    uint mask = notAConstructor ? NotAConstructor : 0;
 
-        if ((query & FinalInCppFunctions) && !f->isFinalInCpp())
-            continue;
+    // Constructors only pass queries with the Constructors option, so they
+    // are tested with it; a constructor failing it fails every query anyway
+    uint required = notAConstructor ? 0 : uint(Constructors);
+    for (uint option = 1; option != NotAConstructor; option <<= 1) {
+        if (functionMatchesQuery<RuntimeQuery>(f, option | required))
+            mask |= option;
+    }
+    return mask;
+}
 
-        if ((query & VirtualInCppFunctions) && f->isFinalInCpp())
-            continue;
+static FunctionModificationList collectFunctionModifications(const AbstractMetaClass *implementor,
+                                                              const AbstractMetaFunction *function)
+{
+    FunctionModificationList mods;
+    while (implementor) {
+        mods += implementor->typeEntry()->functionModifications(function->minimalSignature());
+        if ((implementor == implementor->baseClass()) ||
+            (implementor == function->implementingClass() && (mods.size() > 0)))
+                break;
+        implementor = implementor->baseClass();
+    }
+    return mods;
+}
 
-        if ((query & Signals) && (!f->isSignal()))
-            continue;
+FunctionModificationList AbstractMetaClass::functionModifications(const AbstractMetaFunction *function) const
+{
+    if (!m_cacheFunctionModifications)
+        return collectFunctionModifications(this, function);
 
-        if ((query & ForcedShellFunctions) &&
-            (!f->isForcedShellImplementation() || !f->isFinal())) {
-            continue;
+    // The walk only depends on the signature and where it stops
+    QPair<QString, const AbstractMetaClass *> key(function->minimalSignature(), function->implementingClass());
+    uint revision = classHierarchyRevision;
+    {
+        QReadLocker locker(&m_functionMemoLock);
+        if (m_functionModificationsRevision == revision) {
+            QHash<QPair<QString, const AbstractMetaClass *>, FunctionModificationList>::const_iterator it = m_functionModifications.constFind(key);
+            if (it != m_functionModifications.constEnd())
+                return it.value();
         }
+    }
 
-        if ((query & Constructors) && (!f->isConstructor() || f->ownerClass() != f->implementingClass()))
-            continue;
-
-        if (!(query & Constructors) && f->isConstructor())
-            continue;
-
-        // Destructors are never included in the functions of a class currently
-        /*
-           if ((query & Destructors) && (!f->isDestructor()
-                                       || f->ownerClass() != f->implementingClass())
-            || f->isDestructor() && (query & Destructors) == 0) {
-            continue;
-        }*/
+    FunctionModificationList mods = collectFunctionModifications(this, function);
 
-        if ((query & VirtualFunctions) && (f->isFinal() || f->isSignal() || f->isStatic()))
-            continue;
+    QWriteLocker locker(&m_functionMemoLock);
+    if (m_functionModificationsRevision != revision) {
+        m_functionModifications.clear();
+        m_functionModificationsRevision = revision;
+    }
+    m_functionModifications.insert(key, mods);
+    return mods;
+}
 
-        if ((query & StaticFunctions) && (!f->isStatic() || f->isSignal()))
-            continue;
+void AbstractMetaClass::cacheFunctionModifications()
+{
+    m_cacheFunctionModifications = true;
+}
 
-        if ((query & NonStaticFunctions) && (f->isStatic()))
-            continue;
+void AbstractMetaClass::freezeFunctionQueries()
+{
+    // the masks look up modifications, which takes the lock itself
+    QVector<uint> masks(m_functions.size());
+    for (int i = 0; i < m_functions.size(); ++i)
+        masks[i] = functionQueryMask(m_functions.at(i));
 
-        if ((query & NonEmptyFunctions) && (f->isEmptyFunction()))
-            continue;
+    QWriteLocker locker(&m_functionMemoLock);
+    m_functionQueries.clear();
+    m_functionModifications.clear();
+    m_functionQueryMasks = masks;
+    m_functionQueriesFrozen = true;
+    m_cacheFunctionModifications = true;
+}
 
-        if ((query & NormalFunctions) && (f->isSignal()))
-            continue;
+void AbstractMetaClass::unfreezeFunctionQueries()
+{
+    QWriteLocker locker(&m_functionMemoLock);
+    m_functionQueriesFrozen = false;
+    m_functionQueryMasks.clear();
+    m_functionQueries.clear();
+    m_functionModifications.clear();
+}
 
-        if ((query & AbstractFunctions) && !f->isAbstract())
-            continue;
+AbstractMetaFunctionList AbstractMetaClass::queryFrozenFunctions(uint query) const
+{
+    {
+        QReadLocker locker(&m_functionMemoLock);
+        QHash<uint, AbstractMetaFunctionList>::const_iterator it = m_functionQueries.constFind(query);
+        if (it != m_functionQueries.constEnd())
+            return it.value();
+    }
 
-        if ((query & OperatorOverloads) && !f->isOperatorOverload())
-            continue;
+    uint required = query;
+    if (!(query & Constructors))
+        required |= NotAConstructor;
 
-        functions << f;
+    AbstractMetaFunctionList functions;
+    const uint *masks = m_functionQueryMasks.constData();
+    for (int i = 0; i < m_functionQueryMasks.size(); ++i) {
+        if ((required & ~masks[i]) == 0)
+            functions << m_functions.at(i);
     }
 
+    QWriteLocker locker(&m_functionMemoLock);
+    m_functionQueries.insert(query, functions);
     return functions;
 }
 
-
 bool AbstractMetaClass::hasInconsistentFunctions() const
 {
     return cppInconsistentFunctions().size() > 0;
@@ -2064,6 +2097,38 @@ static void addExtraIncludesForFunction(AbstractMetaClass *metaClass, const Abst
     addExtraIncludeForType(metaClass, argument->type());
 }
 
+// Super classes can never be final
+static void makeExtensible(AbstractMetaClass *superClass)
+{
+    if (superClass->isFinalInTargetLang()) {
+        ReportHandler::warning("Final class '" + superClass->name() + "' set to non-final, as it is extended by other classes");
+        *superClass -= AbstractMetaAttributes::FinalInTargetLang;
+    }
+}
+
+// Fills the lazily computed names that fixFunctions() reads from inherited
+// functions, so that sibling classes fixed in parallel only read them
+static void cacheInheritedFunctions(const AbstractMetaClass *superClass)
+{
+    foreach (const AbstractMetaFunction *f, superClass->functions()) {
+        f->minimalSignature();
+        f->modifiedName();
+        f->signature();
+        if (f->type())
+            f->type()->name();
+        foreach (const AbstractMetaArgument *arg, f->arguments())
+            arg->type()->name();
+    }
+}
+
+void AbstractMetaClass::prepareFixFunctions()
+{
+    for (AbstractMetaClass *superClass = baseClass(); superClass; superClass = superClass->baseClass()) {
+        makeExtensible(superClass);
+        cacheInheritedFunctions(superClass);
+    }
+}
+
 void AbstractMetaClass::fixFunctions()
 {
     if (m_functionsFixed)
@@ -2083,17 +2148,13 @@ void AbstractMetaClass::fixFunctions()
         // we may have propagated from their base classes again.
         AbstractMetaFunctionList superFuncs;
         if (superClass) {
-            // Super classes can never be final
-            if (superClass->isFinalInTargetLang()) {
-                ReportHandler::warning("Final class '" + superClass->name() + "' set to non-final, as it is extended by other classes");
-                *superClass -= AbstractMetaAttributes::FinalInTargetLang;
-            }
-            superFuncs = superClass->queryFunctions(AbstractMetaClass::ClassImplements);
-            AbstractMetaFunctionList virtuals = superClass->queryFunctions(AbstractMetaClass::VirtualInCppFunctions);
+            makeExtensible(superClass);
+            superFuncs = superClass->queryFunctions<AbstractMetaClass::ClassImplements>();
+            AbstractMetaFunctionList virtuals = superClass->queryFunctions<AbstractMetaClass::VirtualInCppFunctions>();
             superFuncs += virtuals;
         } else {
-            superFuncs = interfaces().at(iface_idx)->queryFunctions(AbstractMetaClass::NormalFunctions);
-            AbstractMetaFunctionList virtuals = interfaces().at(iface_idx)->queryFunctions(AbstractMetaClass::VirtualInCppFunctions);
+            superFuncs = interfaces().at(iface_idx)->queryFunctions<AbstractMetaClass::NormalFunctions>();
+            AbstractMetaFunctionList virtuals = interfaces().at(iface_idx)->queryFunctions<AbstractMetaClass::VirtualInCppFunctions>();
             superFuncs += virtuals;
         }
 
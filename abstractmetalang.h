@@ -26,9 +26,12 @@
 
 #include "typesystem.h"
 
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
+#include <QtCore/QVector>
 #include <QSharedPointer>
 
 
@@ -1413,9 +1416,12 @@ public:
               m_hasCloneOperator(false),
               m_isTypeAlias(false),
               m_hasToStringCapability(false),
+              m_functionQueriesFrozen(false),
+              m_cacheFunctionModifications(false),
               m_enclosingClass(0),
               m_baseClass(0),
               m_templateBaseClass(0),
+              m_functionModificationsRevision(0),
               m_extractedInterface(0),
               m_primaryInterfaceImplementor(0),
               m_typeEntry(0),
@@ -1427,6 +1433,14 @@ public:
 
     AbstractMetaClass *extractInterface();
     void fixFunctions();
+    /**
+     *   Does what fixFunctions() would do to other classes than this one:
+     *   the base classes are made non-final and the lazily computed data of
+     *   the inherited functions is filled in. Once that is done for a set
+     *   of classes without interfaces whose base classes are fixed,
+     *   fixFunctions() may run for them concurrently.
+     */
+    void prepareFixFunctions();
 
     AbstractMetaFunctionList functions() const
     {
@@ -1489,6 +1503,51 @@ public:
 
     AbstractMetaFunctionList queryFunctionsByName(const QString &name) const;
     AbstractMetaFunctionList queryFunctions(uint query) const;
+
+    /**
+     *   Same as queryFunctions(uint) for a query known at compile time, like
+     *   queryFunctions<Signals | Visible>(): only the checks for the options
+     *   in \p Query end up in the generated filter.
+     */
+    template <uint Query>
+    AbstractMetaFunctionList queryFunctions() const
+    {
+        if (m_functionQueriesFrozen)
+            return queryFrozenFunctions(Query);
+
+        AbstractMetaFunctionList functions;
+        foreach (AbstractMetaFunction *f, m_functions) {
+            if (functionMatchesQuery<Query>(f, Query))
+                functions << f;
+        }
+        return functions;
+    }
+
+    /**
+     *   Computes which query options each function of this class satisfies
+     *   and memoizes the results of queryFunctions() from then on. Meant to
+     *   be called once the meta model is complete; adding or setting
+     *   functions drops the precomputed data, but changing the attributes
+     *   of the functions themselves afterwards is not noticed.
+     *   Also starts memoizing functionModifications().
+     */
+    void freezeFunctionQueries();
+
+    /**
+     *   Memoizes functionModifications() from now on. Meant to be called
+     *   once the type system is loaded: the memo is dropped when functions
+     *   are added or set and when a base class changes, but not when
+     *   modifications are added to type entries.
+     */
+    void cacheFunctionModifications();
+
+    /**
+     *   The type system modifications of \p function when implemented by
+     *   this class: those of this class and of its base classes up to the
+     *   first one implementing the function that has some.
+     *   This is what AbstractMetaFunction::modifications() returns.
+     */
+    FunctionModificationList functionModifications(const AbstractMetaFunction *function) const;
     inline AbstractMetaFunctionList allVirtualFunctions() const;
     inline AbstractMetaFunctionList allFinalFunctions() const;
     AbstractMetaFunctionList functionsInTargetLang() const;
@@ -1908,6 +1967,113 @@ public:
         return m_hasToStringCapability;
     }
 private:
+    void unfreezeFunctionQueries();
+    AbstractMetaFunctionList queryFrozenFunctions(uint query) const;
+    static uint functionQueryMask(const AbstractMetaFunction *f);
+
+    // StaticQuery argument of functionMatchesQuery() for queries only known at run time
+    static const uint RuntimeQuery = 0xffffffff;
+
+    /**
+     *   The filter of queryFunctions(). When \p StaticQuery is a fixed query
+     *   every option test below is a constant, so each instantiation only
+     *   keeps the predicates that query needs; with RuntimeQuery the options
+     *   are read from \p query instead.
+     */
+    template <uint StaticQuery>
+    static bool functionMatchesQuery(const AbstractMetaFunction *f, uint query)
+    {
+        const uint q = StaticQuery == RuntimeQuery ? query : StaticQuery;
+
+        if ((q & VirtualSlots) && !f->isVirtualSlot())
+            return false;
+
+        if ((q & NotRemovedFromTargetLang) && f->isRemovedFrom(f->implementingClass(), TypeSystem::TargetLangCode))
+            return false;
+
+        if ((q & NotRemovedFromTargetLang) && !f->isFinal() && f->isRemovedFrom(f->declaringClass(), TypeSystem::TargetLangCode))
+            return false;
+
+        if ((q & NotRemovedFromShell) && f->isRemovedFrom(f->implementingClass(), TypeSystem::ShellCode))
+            return false;
+
+        if ((q & NotRemovedFromShell) && !f->isFinal() && f->isRemovedFrom(f->declaringClass(), TypeSystem::ShellCode))
+            return false;
+
+        if ((q & Visible) && f->isPrivate())
+            return false;
+
+        if ((q & VirtualInTargetLangFunctions) && f->isFinalInTargetLang())
+            return false;
+
+        if ((q & Invisible) && !f->isPrivate())
+            return false;
+
+        if ((q & Empty) && !f->isEmptyFunction())
+            return false;
+
+        if ((q & WasPublic) && !f->wasPublic())
+            return false;
+
+        if ((q & WasVisible) && f->wasPrivate())
+            return false;
+
+        if ((q & WasProtected) && !f->wasProtected())
+            return false;
+
+        if ((q & ClassImplements) && f->ownerClass() != f->implementingClass())
+            return false;
+
+        if ((q & Inconsistent) && (f->isFinalInTargetLang() || !f->isFinalInCpp() || f->isStatic()))
+            return false;
+
+        if ((q & FinalInTargetLangFunctions) && !f->isFinalInTargetLang())
+            return false;
+
+        if ((q & FinalInCppFunctions) && !f->isFinalInCpp())
+            return false;
+
+        if ((q & VirtualInCppFunctions) && f->isFinalInCpp())
+            return false;
+
+        if ((q & Signals) && (!f->isSignal()))
+            return false;
+
+        if ((q & ForcedShellFunctions) && (!f->isForcedShellImplementation() || !f->isFinal()))
+            return false;
+
+        if ((q & Constructors) && (!f->isConstructor() || f->ownerClass() != f->implementingClass()))
+            return false;
+
+        if (!(q & Constructors) && f->isConstructor())
+            return false;
+
+        // Destructors are never included in the functions of a class currently
+
+        if ((q & VirtualFunctions) && (f->isFinal() || f->isSignal() || f->isStatic()))
+            return false;
+
+        if ((q & StaticFunctions) && (!f->isStatic() || f->isSignal()))
+            return false;
+
+        if ((q & NonStaticFunctions) && (f->isStatic()))
+            return false;
+
+        if ((q & NonEmptyFunctions) && (f->isEmptyFunction()))
+            return false;
+
+        if ((q & NormalFunctions) && (f->isSignal()))
+            return false;
+
+        if ((q & AbstractFunctions) && !f->isAbstract())
+            return false;
+
+        if ((q & OperatorOverloads) && !f->isOperatorOverload())
+            return false;
+
+        return true;
+    }
+
     uint m_namespace : 1;
     uint m_qobject : 1;
     uint m_hasVirtuals : 1;
@@ -1925,12 +2091,24 @@ private:
     uint m_hasCloneOperator : 1;
     uint m_isTypeAlias : 1;
     uint m_hasToStringCapability : 1;
-    uint m_reserved : 17;
+    uint m_functionQueriesFrozen : 1;
+    uint m_cacheFunctionModifications : 1;
+    uint m_reserved : 15;
 
     const AbstractMetaClass *m_enclosingClass;
     AbstractMetaClass *m_baseClass;
     const AbstractMetaClass *m_templateBaseClass;
     AbstractMetaFunctionList m_functions;
+    // per function of m_functions, the query options it satisfies
+    QVector<uint> m_functionQueryMasks;
+    // guards the two memos below, which are filled from const methods
+    // that may run on several threads
+    mutable QReadWriteLock m_functionMemoLock;
+    mutable QHash<uint, AbstractMetaFunctionList> m_functionQueries;
+    // functionModifications() by minimal signature and implementing class,
+    // valid for the class hierarchy revision m_functionModificationsRevision
+    mutable QHash<QPair<QString, const AbstractMetaClass *>, FunctionModificationList> m_functionModifications;
+    mutable uint m_functionModificationsRevision;
     AbstractMetaFieldList m_fields;
     AbstractMetaEnumList m_enums;
     AbstractMetaClassList m_interfaces;
@@ -2043,29 +2221,29 @@ private:
 
 inline AbstractMetaFunctionList AbstractMetaClass::allVirtualFunctions() const
 {
-    return queryFunctions(VirtualFunctions | NotRemovedFromTargetLang);
+    return queryFunctions<VirtualFunctions | NotRemovedFromTargetLang>();
 }
 
 inline AbstractMetaFunctionList AbstractMetaClass::allFinalFunctions() const
 {
-    return queryFunctions(FinalInTargetLangFunctions
+    return queryFunctions<FinalInTargetLangFunctions
                           | FinalInCppFunctions
-                          | NotRemovedFromTargetLang);
+                          | NotRemovedFromTargetLang>();
 }
 
 inline AbstractMetaFunctionList AbstractMetaClass::cppInconsistentFunctions() const
 {
-    return queryFunctions(Inconsistent
+    return queryFunctions<Inconsistent
                           | NormalFunctions
                           | Visible
-                          | NotRemovedFromTargetLang);
+                          | NotRemovedFromTargetLang>();
 }
 
 inline AbstractMetaFunctionList AbstractMetaClass::cppSignalFunctions() const
 {
-    return queryFunctions(Signals
+    return queryFunctions<Signals
                           | Visible
-                          | NotRemovedFromTargetLang);
+                          | NotRemovedFromTargetLang>();
 }
 
 #endif // ABSTRACTMETALANG_H
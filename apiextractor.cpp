@@ -33,13 +33,14 @@
 #include "parser/rpp/pp.h"
 #include "abstractmetabuilder.h"
 #include "apiextractorversion.h"
+#include "asttoxml.h"
 #include "typedatabase.h"
 
 static bool preprocess(const QString& sourceFile,
                        QFile& targetFile,
                        const QStringList& includes);
 
-ApiExtractor::ApiExtractor() : m_builder(0)
+ApiExtractor::ApiExtractor() : m_builder(0), m_threadCount(1), m_streamingCodeModelDump(false)
 {
     // Environment TYPESYSTEMPATH
     QString envTypesystemPaths = getenv("TYPESYSTEMPATH");
@@ -79,6 +80,22 @@ void ApiExtractor::setLogDirectory(const QString& logDir)
     m_logDirectory = logDir;
 }
 
+void ApiExtractor::setSnapshotDirectory(const QString& snapshotDir)
+{
+    m_snapshotDirectory = snapshotDir;
+}
+
+void ApiExtractor::setThreadCount(int threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+void ApiExtractor::setCodeModelDump(const QString& fileName, bool streaming)
+{
+    m_codeModelDumpFile = fileName;
+    m_streamingCodeModelDump = streaming;
+}
+
 void ApiExtractor::setCppFileName(const QString& cppFileName)
 {
     m_cppFileName = cppFileName;
@@ -155,32 +172,11 @@ QSet<QString> ApiExtractor::qtMetaTypeDeclaredTypeNames() const
     return m_builder->qtMetaTypeDeclaredTypeNames();
 }
 
-static const AbstractMetaEnum* findEnumOnClasses(AbstractMetaClassList metaClasses, const EnumTypeEntry* typeEntry)
-{
-    const AbstractMetaEnum* result = 0;
-    foreach (const AbstractMetaClass* metaClass, metaClasses) {
-        foreach (const AbstractMetaEnum* metaEnum, metaClass->enums()) {
-            if (metaEnum->typeEntry() == typeEntry) {
-                result = metaEnum;
-                break;
-            }
-        }
-        if (result)
-            break;
-        result = findEnumOnClasses(metaClass->innerClasses(), typeEntry);
-    }
-    return result;
-}
-
 const AbstractMetaEnum* ApiExtractor::findAbstractMetaEnum(const EnumTypeEntry* typeEntry) const
 {
     if (!typeEntry)
         return 0;
-    foreach (AbstractMetaEnum* metaEnum, m_builder->globalEnums()) {
-        if (metaEnum->typeEntry() == typeEntry)
-            return metaEnum;
-    }
-    return findEnumOnClasses(m_builder->classes(), typeEntry);
+    return m_builder->findEnum(typeEntry);
 }
 
 const AbstractMetaEnum* ApiExtractor::findAbstractMetaEnum(const TypeEntry* typeEntry) const
@@ -237,11 +233,27 @@ bool ApiExtractor::run()
         return false;
     }
     ppFile.seek(0);
+
+    if (!m_codeModelDumpFile.isEmpty()) {
+        ppFile.flush();
+        QFile dumpFile(m_codeModelDumpFile);
+        if (dumpFile.open(QIODevice::WriteOnly))
+            astToXML(ppFile.fileName(), &dumpFile, m_streamingCodeModelDump);
+        else
+            std::cerr << "Cannot write code model dump: " << qPrintable(m_codeModelDumpFile) << std::endl;
+    }
+
     m_builder = new AbstractMetaBuilder;
     m_builder->setLogDirectory(m_logDirectory);
+    m_builder->setSnapshotDirectory(m_snapshotDirectory);
+    m_builder->setThreadCount(m_threadCount);
     m_builder->setGlobalHeader(m_cppFileName);
     m_builder->build(&ppFile);
 
+    // From here on the type database is only queried, possibly by the
+    // generators from several threads
+    TypeDatabase::instance()->freeze();
+
     return true;
 }
 
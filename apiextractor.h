@@ -48,6 +48,20 @@ public:
     void addIncludePath(const QString& path);
     void addIncludePath(const QStringList& paths);
     void setLogDirectory(const QString& logDir);
+    void setSnapshotDirectory(const QString& snapshotDir);
+    /**
+     * Threads for AbstractMetaBuilder::setThreadCount(), which only fix the
+     * functions of the classes in parallel: the class model itself is
+     * still generated on the calling thread.
+     */
+    void setThreadCount(int threadCount);
+    /**
+     * Also dumps the classes and namespaces of the preprocessed input as
+     * XML to \p fileName, see astToXML(). The streaming mode binds the
+     * input a block at a time, for inputs whose code model is too large
+     * to be held in memory at once.
+     */
+    void setCodeModelDump(const QString& fileName, bool streaming = false);
     APIEXTRACTOR_DEPRECATED(void setApiVersion(double version));
     void setApiVersion(const QString& package, const QByteArray& version);
     void setDropTypeEntries(QString dropEntries);
@@ -73,6 +87,10 @@ private:
     QStringList m_includePaths;
     AbstractMetaBuilder* m_builder;
     QString m_logDirectory;
+    QString m_snapshotDirectory;
+    int m_threadCount;
+    QString m_codeModelDumpFile;
+    bool m_streamingCodeModelDump;
 
     // disable copy
     ApiExtractor(const ApiExtractor&);
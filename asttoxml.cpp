@@ -32,13 +32,276 @@
 #include <QtCore/QTextCodec>
 #include <QtCore/QFile>
 
+#include <cctype>
+
+static void writeOutFile(QXmlStreamWriter &s, const FileModelItem &dom)
+{
+    foreach (const NamespaceModelItem &ns, dom->namespaceMap())
+        writeOutNamespace(s, ns);
+
+    foreach (const ClassModelItem &klass, dom->classMap())
+        writeOutClass(s, klass);
+}
+
+// Returns the start of the first '# line "file"' marker after
+// @p begin + @p blockSize before which all declarations are complete,
+// or @p end.
+static const char *blockEnd(const char *begin, const char *end, int blockSize)
+{
+    int braces = 0;
+    int parens = 0;
+    char last = 0;
+    bool lineStart = true;
+
+    for (const char *cursor = begin; cursor != end; ++cursor) {
+        char c = *cursor;
+        if (lineStart && c == '#') {
+            if (cursor != begin && cursor - begin >= blockSize && braces == 0 && parens == 0
+                && (last == 0 || last == ';' || last == '}')
+                && end - cursor > 2 && cursor[1] == ' ' && std::isdigit((unsigned char) cursor[2])) {
+                return cursor;
+            }
+            while (cursor + 1 != end && cursor[1] != '\n')
+                ++cursor;
+            continue;
+        }
+        lineStart = (c == '\n');
+
+        switch (c) {
+        case '"':
+        case '\'':
+            while (cursor + 1 != end && *++cursor != c) {
+                if (*cursor == '\\' && cursor + 1 != end)
+                    ++cursor;
+            }
+            break;
+        case '{':
+            ++braces;
+            break;
+        case '}':
+            --braces;
+            break;
+        case '(':
+            ++parens;
+            break;
+        case ')':
+            --parens;
+            break;
+        }
+
+        if (!std::isspace((unsigned char) c))
+            last = c;
+    }
+
+    return end;
+}
+
+// The namespaces and classes of a released block, without their members,
+// with the names of their enums and their type aliases; the aliased types
+// are kept too, as the later blocks resolve template arguments through them
+struct ScopeOutline
+{
+    bool isClass;
+    QString name;
+    QString fileName;
+    QStringList baseClasses;
+    CodeModel::ClassType classType;
+    QList<ScopeOutline> members;
+    QStringList enums;
+    QList<QPair<QString, TypeInfo> > typeAliases;
+};
+
+static void outlineScope(const ScopeModelItem &scope, ScopeOutline *outline)
+{
+    if (NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(scope)) {
+        foreach (const NamespaceModelItem &inner, ns->namespaceMap()) {
+            ScopeOutline member;
+            member.isClass = false;
+            member.name = inner->name();
+            member.fileName = inner->fileName();
+            outlineScope(model_static_cast<ScopeModelItem>(inner), &member);
+            outline->members.append(member);
+        }
+    }
+
+    const QHash<QString, ClassModelItem> &classes = scope->classMap();
+    for (QHash<QString, ClassModelItem>::const_iterator it = classes.begin(); it != classes.end(); ++it) {
+        // template classes are also listed under their short name
+        if (it.key() != it.value()->name())
+            continue;
+        ScopeOutline member;
+        member.isClass = true;
+        member.name = it.value()->name();
+        member.fileName = it.value()->fileName();
+        member.baseClasses = it.value()->baseClasses();
+        member.classType = it.value()->classType();
+        outlineScope(model_static_cast<ScopeModelItem>(it.value()), &member);
+        outline->members.append(member);
+    }
+
+    outline->enums = scope->enumMap().keys();
+    foreach (const TypeAliasModelItem &alias, scope->typeAliasMap())
+        outline->typeAliases.append(qMakePair(alias->name(), alias->type()));
+}
+
+static void restoreScope(CodeModel *model, const ScopeModelItem &scope, const ScopeOutline &outline)
+{
+    foreach (const ScopeOutline &member, outline.members) {
+        if (member.isClass) {
+            ClassModelItem klass = model->create<ClassModelItem>();
+            klass->setName(member.name);
+            klass->setFileName(member.fileName);
+            klass->setScope(scope->qualifiedName());
+            klass->setBaseClasses(member.baseClasses);
+            klass->setClassType(member.classType);
+            scope->addClass(klass);
+            restoreScope(model, model_static_cast<ScopeModelItem>(klass), member);
+        } else {
+            NamespaceModelItem ns = model->create<NamespaceModelItem>();
+            ns->setName(member.name);
+            ns->setFileName(member.fileName);
+            ns->setScope(scope->qualifiedName());
+            restoreScope(model, model_static_cast<ScopeModelItem>(ns), member);
+            model_static_cast<NamespaceModelItem>(scope)->addNamespace(ns);
+        }
+    }
+
+    foreach (const QString &name, outline.enums) {
+        EnumModelItem enumItem = model->create<EnumModelItem>();
+        enumItem->setName(name);
+        enumItem->setScope(scope->qualifiedName());
+        scope->addEnum(enumItem);
+    }
+
+    for (int i = 0; i < outline.typeAliases.size(); ++i) {
+        TypeAliasModelItem alias = model->create<TypeAliasModelItem>();
+        alias->setName(outline.typeAliases.at(i).first);
+        alias->setScope(scope->qualifiedName());
+        alias->setType(outline.typeAliases.at(i).second);
+        scope->addTypeAlias(alias);
+    }
+}
+
+static bool hasNewItems(const NamespaceModelItem &ns, std::size_t first)
+{
+    foreach (const NamespaceModelItem &inner, ns->namespaceMap()) {
+        if (inner->creationId() >= first || hasNewItems(inner, first))
+            return true;
+    }
+    foreach (const ClassModelItem &klass, ns->classMap()) {
+        if (klass->creationId() >= first)
+            return true;
+    }
+    foreach (const EnumModelItem &enumItem, ns->enumMap()) {
+        if (enumItem->creationId() >= first)
+            return true;
+    }
+    return false;
+}
+
+// Writes the namespaces and classes of @p ns created from item id
+// @p first on, i.e. those of the last block.
+static void writeOutNewItems(QXmlStreamWriter &s, const NamespaceModelItem &ns, std::size_t first)
+{
+    foreach (const NamespaceModelItem &inner, ns->namespaceMap()) {
+        if (inner->creationId() >= first) {
+            writeOutNamespace(s, inner);
+        } else if (hasNewItems(inner, first)) {
+            s.writeStartElement("namespace");
+            s.writeAttribute("name", inner->name());
+
+            writeOutNewItems(s, inner, first);
+            foreach (const EnumModelItem &enumItem, inner->enumMap()) {
+                if (enumItem->creationId() >= first)
+                    writeOutEnum(s, enumItem);
+            }
+
+            s.writeEndElement();
+        }
+    }
+
+    foreach (const ClassModelItem &klass, ns->classMap()) {
+        if (klass->creationId() >= first)
+            writeOutClass(s, klass);
+    }
+}
+
+static void streamToXML(QFile &file, QXmlStreamWriter &s, int blockSize)
+{
+    // The lexer stops at a NUL behind the input. A block cut before a line
+    // marker ends on the newline before it, so only the last one needs a
+    // copy with the terminator.
+    QByteArray buffer;
+    qint64 size = file.size();
+    const char *begin = reinterpret_cast<const char *>(file.map(0, size));
+    if (!begin) {
+        buffer = file.readAll();
+        begin = buffer.constData();
+        size = buffer.size();
+    }
+    const char *end = begin + size;
+
+    // The name symbols point into the input, which is kept until the end.
+    Control control;
+    Parser p(&control);
+
+    CodeModel model;
+    Binder binder(&model, p.location());
+    FileModelItem dom = model.create<FileModelItem>();
+
+    QByteArray tail;
+    for (const char *cursor = begin; cursor != end;) {
+        const char *next = blockEnd(cursor, end, blockSize);
+        const char *contents = cursor;
+        if (next == end && buffer.isEmpty()) {
+            tail = QByteArray(cursor, int(end - cursor));
+            contents = tail.constData();
+        }
+
+        std::size_t first = model.nextCreationId();
+        {
+            pool __pool;
+            TranslationUnitAST *ast = p.parse(contents, next - cursor, &__pool);
+            binder.run(ast, dom);
+        }
+        writeOutNewItems(s, dom, first);
+
+        ScopeOutline outline;
+        outlineScope(model_static_cast<ScopeModelItem>(dom), &outline);
+        model.releaseItems();
+        dom = model.create<FileModelItem>();
+        restoreScope(&model, model_static_cast<ScopeModelItem>(dom), outline);
+
+        cursor = next;
+    }
+}
+
 void astToXML(QString name)
+{
+    QFile outputFile;
+    if (!outputFile.open(stdout, QIODevice::WriteOnly))
+        return;
+
+    astToXML(name, &outputFile);
+}
+
+void astToXML(QString name, QIODevice *output, bool streaming, int blockSize)
 {
     QFile file(name);
 
     if (!file.open(QFile::ReadOnly))
         return;
 
+    QXmlStreamWriter s(output);
+    s.setAutoFormatting(true);
+
+    if (streaming) {
+        s.writeStartElement("code");
+        streamToXML(file, s, blockSize);
+        s.writeEndElement();
+        return;
+    }
+
     QTextStream stream(&file);
     stream.setCodec(QTextCodec::codecForName("UTF-8"));
     QByteArray contents = stream.readAll().toUtf8();
@@ -54,54 +317,35 @@ void astToXML(QString name)
     Binder binder(&model, p.location());
     FileModelItem dom = binder.run(ast);
 
-    QFile outputFile;
-    if (!outputFile.open(stdout, QIODevice::WriteOnly))
-        return;
-
-    QXmlStreamWriter s(&outputFile);
-    s.setAutoFormatting(true);
-
     s.writeStartElement("code");
-
-    QHash<QString, NamespaceModelItem> namespaceMap = dom->namespaceMap();
-    foreach (NamespaceModelItem item, namespaceMap.values())
-        writeOutNamespace(s, item);
-
-    QHash<QString, ClassModelItem> typeMap = dom->classMap();
-    foreach (ClassModelItem item, typeMap.values())
-        writeOutClass(s, item);
-
+    writeOutFile(s, dom);
     s.writeEndElement();
 }
 
-
-void writeOutNamespace(QXmlStreamWriter &s, NamespaceModelItem &item)
+void writeOutNamespace(QXmlStreamWriter &s, const NamespaceModelItem &item)
 {
     s.writeStartElement("namespace");
     s.writeAttribute("name", item->name());
 
-    QHash<QString, NamespaceModelItem> namespaceMap = item->namespaceMap();
-    foreach (NamespaceModelItem item, namespaceMap.values())
-        writeOutNamespace(s, item);
+    foreach (const NamespaceModelItem &ns, item->namespaceMap())
+        writeOutNamespace(s, ns);
 
-    QHash<QString, ClassModelItem> typeMap = item->classMap();
-    foreach (ClassModelItem item, typeMap.values())
-        writeOutClass(s, item);
+    foreach (const ClassModelItem &klass, item->classMap())
+        writeOutClass(s, klass);
 
-    QHash<QString, EnumModelItem> enumMap = item->enumMap();
-    foreach (EnumModelItem item, enumMap.values())
-        writeOutEnum(s, item);
+    foreach (const EnumModelItem &enumItem, item->enumMap())
+        writeOutEnum(s, enumItem);
 
     s.writeEndElement();
 }
 
-void writeOutEnum(QXmlStreamWriter &s, EnumModelItem &item)
+void writeOutEnum(QXmlStreamWriter &s, const EnumModelItem &item)
 {
     QString qualifiedName = item->qualifiedName().join("::");
     s.writeStartElement("enum");
     s.writeAttribute("name", qualifiedName);
 
-    EnumeratorList enumList = item->enumerators();
+    const EnumeratorList &enumList = item->enumerators();
     for (int i = 0; i < enumList.size() ; i++) {
         s.writeStartElement("enumerator");
         if (!enumList[i]->value().isEmpty())
@@ -113,13 +357,13 @@ void writeOutEnum(QXmlStreamWriter &s, EnumModelItem &item)
     s.writeEndElement();
 }
 
-void writeOutFunction(QXmlStreamWriter &s, FunctionModelItem &item)
+void writeOutFunction(QXmlStreamWriter &s, const FunctionModelItem &item)
 {
     QString qualifiedName = item->qualifiedName().join("::");
     s.writeStartElement("function");
     s.writeAttribute("name", qualifiedName);
 
-    ArgumentList arguments = item->arguments();
+    const ArgumentList &arguments = item->arguments();
     for (int i = 0; i < arguments.size() ; i++) {
         s.writeStartElement("argument");
         s.writeAttribute("type",  arguments[i]->type().qualifiedName().join("::"));
@@ -128,23 +372,20 @@ void writeOutFunction(QXmlStreamWriter &s, FunctionModelItem &item)
     s.writeEndElement();
 }
 
-void writeOutClass(QXmlStreamWriter &s, ClassModelItem &item)
+void writeOutClass(QXmlStreamWriter &s, const ClassModelItem &item)
 {
     QString qualifiedName = item->qualifiedName().join("::");
     s.writeStartElement("class");
     s.writeAttribute("name", qualifiedName);
 
-    QHash<QString, EnumModelItem> enumMap = item->enumMap();
-    foreach (EnumModelItem item, enumMap.values())
-        writeOutEnum(s, item);
+    foreach (const EnumModelItem &enumItem, item->enumMap())
+        writeOutEnum(s, enumItem);
 
-    QHash<QString, FunctionModelItem> functionMap = item->functionMap();
-    foreach (FunctionModelItem item, functionMap.values())
-        writeOutFunction(s, item);
+    foreach (const FunctionModelItem &function, item->functionMap())
+        writeOutFunction(s, function);
 
-    QHash<QString, ClassModelItem> typeMap = item->classMap();
-    foreach (ClassModelItem item, typeMap.values())
-        writeOutClass(s, item);
+    foreach (const ClassModelItem &klass, item->classMap())
+        writeOutClass(s, klass);
 
     s.writeEndElement();
 }
@@ -30,11 +30,34 @@
 #include <QtCore/QString>
 #include <QtCore/QXmlStreamWriter>
 
+class QIODevice;
+
+/**
+ * Dumps the classes and namespaces declared in the preprocessed file
+ * @p name as XML to the standard output.
+ */
 void astToXML(const QString name);
-void writeOutNamespace(QXmlStreamWriter &s, NamespaceModelItem &item);
-void writeOutEnum(QXmlStreamWriter &s, EnumModelItem &item);
-void writeOutFunction(QXmlStreamWriter &s, FunctionModelItem &item);
-void writeOutClass(QXmlStreamWriter &s, ClassModelItem &item);
+
+/**
+ * Dumps the classes and namespaces declared in the preprocessed file
+ * @p name as XML to @p output.
+ *
+ * In streaming mode the file is memory mapped and bound in blocks of at
+ * least @p blockSize bytes, cut before the line marker of a header once
+ * all declarations before it are complete. Each block is written out as
+ * soon as it is bound, after which its tokens, syntax tree and model
+ * items are released; only the namespaces and classes seen so far are
+ * kept, without their members, to resolve the scopes and base classes of
+ * the later blocks. A namespace is written once per block that adds to
+ * it instead of merged, and members defined out of line for a class of
+ * an earlier block are not written.
+ */
+void astToXML(const QString name, QIODevice *output, bool streaming = false,
+              int blockSize = 64 * 1024);
+void writeOutNamespace(QXmlStreamWriter &s, const NamespaceModelItem &item);
+void writeOutEnum(QXmlStreamWriter &s, const EnumModelItem &item);
+void writeOutFunction(QXmlStreamWriter &s, const FunctionModelItem &item);
+void writeOutClass(QXmlStreamWriter &s, const ClassModelItem &item);
 
 
 #endif // ASTTOXML
@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include <QDebug>
+#include <QStack>
 
 Binder::Binder(CodeModel *__model, LocationManager &__location, Control *__control)
         : _M_model(__model),
@@ -41,17 +42,18 @@ Binder::Binder(CodeModel *__model, LocationManager &__location, Control *__contr
         _M_token_stream(&_M_location.token_stream),
         _M_control(__control),
         _M_current_function_type(CodeModel::Normal),
+        _M_qualified_types_revision(0),
         type_cc(this),
         name_cc(this),
         decl_cc(this)
 {
-    _M_qualified_types["char"] = QString();
-    _M_qualified_types["double"] = QString();
-    _M_qualified_types["float"] = QString();
-    _M_qualified_types["int"] = QString();
-    _M_qualified_types["long"] = QString();
-    _M_qualified_types["short"] = QString();
-    _M_qualified_types["void"] = QString();
+    addQualifiedType(QStringList() << "char");
+    addQualifiedType(QStringList() << "double");
+    addQualifiedType(QStringList() << "float");
+    addQualifiedType(QStringList() << "int");
+    addQualifiedType(QStringList() << "long");
+    addQualifiedType(QStringList() << "short");
+    addQualifiedType(QStringList() << "void");
 }
 
 Binder::~Binder()
@@ -73,6 +75,26 @@ FileModelItem Binder::run(AST *node)
     return result;
 }
 
+void Binder::run(AST *node, FileModelItem file, const AnonymousEnumNumbers &enumNumbers)
+{
+    FileModelItem old = _M_current_file;
+    _M_current_access = CodeModel::Public;
+
+    _M_current_file = file;
+    _M_reused_enum_numbers = enumNumbers;
+    addQualifiedTypes(model_static_cast<ScopeModelItem>(file));
+    // enums the files didn't have before are numbered after all reused ones
+    for (AnonymousEnumNumbers::const_iterator it = enumNumbers.begin(); it != enumNumbers.end(); ++it) {
+        int &last = _M_anonymous_enums[it.key().first];
+        if (!it.value().isEmpty() && it.value().last() > last)
+            last = it.value().last();
+    }
+    visit(node);
+    _M_reused_enum_numbers.clear();
+
+    _M_current_file = old; // restore
+}
+
 ScopeModelItem Binder::currentScope()
 {
     if (_M_current_class)
@@ -521,7 +543,7 @@ void Binder::visitTypedef(TypedefAST *node)
         typeAlias->setName(alias_name);
         typeAlias->setType(qualifyType(typeInfo, currentScope()->qualifiedName()));
         typeAlias->setScope(typedefScope->qualifiedName());
-        _M_qualified_types[typeAlias->qualifiedName().join(".")] = QString();
+        addQualifiedType(typeAlias->qualifiedName());
         currentScope()->addTypeAlias(typeAlias);
     } while (it != end);
 }
@@ -552,7 +574,7 @@ void Binder::visitNamespace(NamespaceAST *node)
         _M_context.append(name);
     }
 
-    DefaultVisitor::visitNamespace(node);
+    StaticVisitor<Binder>::visitNamespace(node);
 
     if (!anonymous) {
         Q_ASSERT(scope->kind() == _CodeModelItem::Kind_Namespace
@@ -574,7 +596,7 @@ void Binder::visitForwardDeclarationSpecifier(ForwardDeclarationSpecifierAST *no
         return;
 
     ScopeModelItem scope = currentScope();
-    _M_qualified_types[(scope->qualifiedName() + name_cc.qualifiedName()).join(".")] = QString();
+    addQualifiedType(scope->qualifiedName() + name_cc.qualifiedName());
 }
 
 void Binder::visitClassSpecifier(ClassSpecifierAST *node)
@@ -624,7 +646,7 @@ void Binder::visitClassSpecifier(ClassSpecifierAST *node)
     CodeModel::FunctionType oldFunctionType = changeCurrentFunctionType(CodeModel::Normal);
 
     _M_current_class->setScope(scope->qualifiedName());
-    _M_qualified_types[_M_current_class->qualifiedName().join(".")] = QString();
+    addQualifiedType(_M_current_class->qualifiedName());
 
     scope->addClass(_M_current_class);
 
@@ -640,12 +662,12 @@ void Binder::visitClassSpecifier(ClassSpecifierAST *node)
 
 void Binder::visitLinkageSpecification(LinkageSpecificationAST *node)
 {
-    DefaultVisitor::visitLinkageSpecification(node);
+    StaticVisitor<Binder>::visitLinkageSpecification(node);
 }
 
 void Binder::visitUsing(UsingAST *node)
 {
-    DefaultVisitor::visitUsing(node);
+    StaticVisitor<Binder>::visitUsing(node);
 }
 
 void Binder::visitEnumSpecifier(EnumSpecifierAST *node)
@@ -657,27 +679,33 @@ void Binder::visitEnumSpecifier(EnumSpecifierAST *node)
     name_cc.run(node->name);
     QString name = name_cc.name();
 
+    _M_current_enum = model()->create<EnumModelItem>();
+    _M_current_enum->setAccessPolicy(_M_current_access);
+    updateItemPosition(_M_current_enum->toItem(), node);
+
     bool isAnonymous = name.isEmpty();
     if (isAnonymous) {
         // anonymous enum
-        QString key = _M_context.join("::");
-        int current = ++_M_anonymous_enums[key];
+        QString key = enumScope->qualifiedName().join("::");
+        AnonymousEnumNumbers::iterator reused = _M_reused_enum_numbers.find(qMakePair(key, _M_current_enum->fileName()));
+        int current;
+        if (reused != _M_reused_enum_numbers.end() && !reused.value().isEmpty())
+            current = reused.value().takeFirst();
+        else
+            current = ++_M_anonymous_enums[key];
         name += QLatin1String("enum_");
         name += QString::number(current);
     }
 
-    _M_current_enum = model()->create<EnumModelItem>();
-    _M_current_enum->setAccessPolicy(_M_current_access);
-    updateItemPosition(_M_current_enum->toItem(), node);
     _M_current_enum->setName(name);
     _M_current_enum->setAnonymous(isAnonymous);
     _M_current_enum->setScope(enumScope->qualifiedName());
 
-    _M_qualified_types[_M_current_enum->qualifiedName().join(".")] = QString();
+    addQualifiedType(_M_current_enum->qualifiedName());
 
     enumScope->addEnum(_M_current_enum);
 
-    DefaultVisitor::visitEnumSpecifier(node);
+    StaticVisitor<Binder>::visitEnumSpecifier(node);
 
     _M_current_enum = 0;
 }
@@ -713,7 +741,7 @@ void Binder::visitEnumerator(EnumeratorAST *node)
 
 void Binder::visitUsingDirective(UsingDirectiveAST *node)
 {
-    DefaultVisitor::visitUsingDirective(node);
+    StaticVisitor<Binder>::visitUsingDirective(node);
 }
 
 void Binder::visitQEnums(QEnumsAST *node)
@@ -808,39 +836,146 @@ void Binder::applyFunctionSpecifiers(const ListNode<std::size_t> *it, FunctionMo
 
 TypeInfo Binder::qualifyType(const TypeInfo &type, const QStringList &context) const
 {
-    // ### Potentially improve to use string list in the name table to
     if (!context.size()) {
         // ### We can assume that this means global namespace for now...
         return type;
-    } else if (_M_qualified_types.contains(type.qualifiedName().join("."))) {
+    }
+
+    CodeModelNameTable *names = model()->nameTable();
+    int typeId = names->pathId(type.qualifiedName());
+    if (_M_qualified_types.contains(typeId))
+        return type;
+
+    // Results depend on the declared types with the same last name and on
+    // the context classes found in the model, so they are only valid as
+    // long as neither changes.
+    QPair<int, int> key(names->pathId(context), typeId);
+    QHash<QPair<int, int>, QualifyResult>::const_iterator it = _M_qualify_cache.constFind(key);
+    bool current = it != _M_qualify_cache.constEnd()
+                   && _M_qualified_name_revisions.value(names->pathNameId(typeId)) <= it.value().qualifiedTypesRevision;
+    if (current) {
+        foreach (int nameId, it.value().nameIds)
+            current = current && model()->nameRevision(nameId) <= it.value().indexRevision;
+    }
+    if (!current) {
+        QualifyResult result;
+        result.qualifiedTypesRevision = _M_qualified_types_revision;
+        result.indexRevision = model()->indexRevision();
+        result.typeId = findQualifiedType(type.qualifiedName(), key.first, &result.nameIds);
+        it = _M_qualify_cache.insert(key, result);
+    }
+
+    if (it.value().typeId < 0)
         return type;
-    } else {
-        QStringList expanded = context;
-        expanded << type.qualifiedName();
-        if (_M_qualified_types.contains(expanded.join("."))) {
-            TypeInfo modified_type = type;
-            modified_type.setQualifiedName(expanded);
-            return modified_type;
-        } else {
-            CodeModelItem scope = model()->findItem(context, _M_current_file->toItem());
-
-            if (ClassModelItem klass = model_dynamic_cast<ClassModelItem> (scope)) {
-                foreach (QString base, klass->baseClasses()) {
-                    QStringList ctx = context;
-                    ctx.removeLast();
-                    ctx.append(base);
-
-                    TypeInfo qualified = qualifyType(type, ctx);
-                    if (qualified != type)
-                        return qualified;
-                }
-            }
 
-            QStringList copy = context;
-            copy.removeLast();
-            return qualifyType(type, copy);
+    TypeInfo modified_type = type;
+    modified_type.setQualifiedName(names->path(it.value().typeId));
+    return modified_type;
+}
+
+void Binder::addQualifiedType(const QStringList &qualifiedName)
+{
+    int id = model()->nameTable()->pathId(qualifiedName);
+    if (!_M_qualified_types.contains(id)) {
+        _M_qualified_types.insert(id);
+        _M_qualified_name_revisions[model()->nameTable()->pathNameId(id)] = ++_M_qualified_types_revision;
+    }
+}
+
+void Binder::addQualifiedTypes(ScopeModelItem scope)
+{
+    // anonymous enums are numbered per scope, go on after the bound ones
+    QString key = scope->qualifiedName().join("::");
+    const QHash<QString, EnumModelItem> &enums = scope->enumMap();
+    for (QHash<QString, EnumModelItem>::const_iterator it = enums.begin(); it != enums.end(); ++it) {
+        addQualifiedType(it.value()->qualifiedName());
+        if (it.key().startsWith(QLatin1String("enum_"))) {
+            bool ok;
+            int number = it.key().mid(5).toInt(&ok);
+            if (ok && number > _M_anonymous_enums.value(key))
+                _M_anonymous_enums[key] = number;
+        }
+    }
+
+    const QHash<QString, TypeAliasModelItem> &typeAliases = scope->typeAliasMap();
+    for (QHash<QString, TypeAliasModelItem>::const_iterator it = typeAliases.begin(); it != typeAliases.end(); ++it)
+        addQualifiedType(it.value()->qualifiedName());
+
+    const QHash<QString, ClassModelItem> &classes = scope->classMap();
+    for (QHash<QString, ClassModelItem>::const_iterator it = classes.begin(); it != classes.end(); ++it) {
+        // template classes are also listed under their short name
+        if (it.key() != it.value()->name())
+            continue;
+        addQualifiedType(it.value()->qualifiedName());
+        addQualifiedTypes(model_static_cast<ScopeModelItem>(it.value()));
+    }
+
+    if (NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(scope)) {
+        const QHash<QString, NamespaceModelItem> &namespaces = ns->namespaceMap();
+        for (QHash<QString, NamespaceModelItem>::const_iterator it = namespaces.begin(); it != namespaces.end(); ++it)
+            addQualifiedTypes(model_static_cast<ScopeModelItem>(it.value()));
+    }
+}
+
+// Splits @p name at the "::" outside of template arguments.
+static QStringList splitQualifiedName(const QString &name)
+{
+    QStringList result;
+    int depth = 0;
+    int start = 0;
+    for (int i = 0; i < name.size(); ++i) {
+        QChar c = name.at(i);
+        if (c == QLatin1Char('<')) {
+            ++depth;
+        } else if (c == QLatin1Char('>')) {
+            --depth;
+        } else if (depth == 0 && c == QLatin1Char(':') && i + 1 < name.size()
+                   && name.at(i + 1) == QLatin1Char(':')) {
+            result.append(name.mid(start, i - start));
+            start = ++i + 1;
         }
     }
+    result.append(name.mid(start));
+    return result;
+}
+
+int Binder::findQualifiedType(const QStringList &name, int contextId, QVector<int> *nameIds) const
+{
+    // Depth first search for a context in which name is a declared type:
+    // first the context itself, then, for classes, the contexts of their
+    // base classes, then the enclosing context. Contexts already searched
+    // through another base class are not searched again.
+    CodeModelNameTable *names = model()->nameTable();
+    QStack<int> pending;
+    QSet<int> visited;
+
+    pending.push(contextId);
+    while (!pending.isEmpty()) {
+        int id = pending.pop();
+        if (id == 0 || visited.contains(id))
+            continue;
+        visited.insert(id);
+
+        int expandedId = names->findPathId(name, id);
+        if (expandedId >= 0 && _M_qualified_types.contains(expandedId))
+            return expandedId;
+
+        int parentId = names->parentPathId(id);
+        pending.push(parentId);
+
+        // the model is searched by each name of the context path
+        for (int pathId = id; pathId != 0; pathId = names->parentPathId(pathId))
+            nameIds->append(names->pathNameId(pathId));
+        CodeModelItem scope = model()->findItem(names->path(id), _M_current_file->toItem());
+        if (ClassModelItem klass = model_dynamic_cast<ClassModelItem> (scope)) {
+            // the base classes were qualified when the class was bound
+            QStringList baseClasses = klass->baseClasses();
+            for (int i = baseClasses.size() - 1; i >= 0; --i)
+                pending.push(names->pathId(splitQualifiedName(baseClasses.at(i))));
+        }
+    }
+
+    return -1;
 }
 
 void Binder::updateItemPosition(CodeModelItem item, AST *node)
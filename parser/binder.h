@@ -26,7 +26,7 @@
 #ifndef BINDER_H
 #define BINDER_H
 
-#include "default_visitor.h"
+#include "static_visitor.h"
 #include "codemodel.h"
 #include "type_compiler.h"
 #include "name_compiler.h"
@@ -37,9 +37,14 @@ class LocationManager;
 class Control;
 struct NameSymbol;
 
-class Binder: protected DefaultVisitor
+class Binder: protected StaticVisitor<Binder>
 {
+    friend class StaticVisitor<Binder>;
+
 public:
+    /// Numbers of anonymous enums by (scope, file name), in input order.
+    typedef QHash<QPair<QString, QString>, QList<int> > AnonymousEnumNumbers;
+
     Binder(CodeModel *__model, LocationManager &__location, Control *__control = 0);
     virtual ~Binder();
 
@@ -57,25 +62,36 @@ public:
 
     FileModelItem run(AST *node);
 
+    /// Binds @p node into the already bound @p file, e.g. to merge back
+    /// the declarations of a re-parsed header. The types declared in
+    /// @p file are used to qualify the new declarations.
+    ///
+    /// Anonymous enums are named after their position in their scope,
+    /// "enum_1" and so on. @p enumNumbers gives the numbers the re-parsed
+    /// files used in each scope, so that their enums keep their names;
+    /// further ones are numbered after the bound enums.
+    void run(AST *node, FileModelItem file,
+             const AnonymousEnumNumbers &enumNumbers = AnonymousEnumNumbers());
+
 // utils
     TypeInfo qualifyType(const TypeInfo &type, const QStringList &context) const;
 
 protected:
-    virtual void visitAccessSpecifier(AccessSpecifierAST *);
-    virtual void visitClassSpecifier(ClassSpecifierAST *);
-    virtual void visitEnumSpecifier(EnumSpecifierAST *);
-    virtual void visitEnumerator(EnumeratorAST *);
-    virtual void visitFunctionDefinition(FunctionDefinitionAST *);
-    virtual void visitLinkageSpecification(LinkageSpecificationAST *);
-    virtual void visitNamespace(NamespaceAST *);
-    virtual void visitSimpleDeclaration(SimpleDeclarationAST *);
-    virtual void visitTemplateDeclaration(TemplateDeclarationAST *);
-    virtual void visitTypedef(TypedefAST *);
-    virtual void visitUsing(UsingAST *);
-    virtual void visitUsingDirective(UsingDirectiveAST *);
-    virtual void visitQProperty(QPropertyAST *);
-    virtual void visitForwardDeclarationSpecifier(ForwardDeclarationSpecifierAST *);
-    virtual void visitQEnums(QEnumsAST *);
+    void visitAccessSpecifier(AccessSpecifierAST *);
+    void visitClassSpecifier(ClassSpecifierAST *);
+    void visitEnumSpecifier(EnumSpecifierAST *);
+    void visitEnumerator(EnumeratorAST *);
+    void visitFunctionDefinition(FunctionDefinitionAST *);
+    void visitLinkageSpecification(LinkageSpecificationAST *);
+    void visitNamespace(NamespaceAST *);
+    void visitSimpleDeclaration(SimpleDeclarationAST *);
+    void visitTemplateDeclaration(TemplateDeclarationAST *);
+    void visitTypedef(TypedefAST *);
+    void visitUsing(UsingAST *);
+    void visitUsingDirective(UsingDirectiveAST *);
+    void visitQProperty(QPropertyAST *);
+    void visitForwardDeclarationSpecifier(ForwardDeclarationSpecifierAST *);
+    void visitQEnums(QEnumsAST *);
 
 private:
 
@@ -98,6 +114,10 @@ private:
 
     void updateItemPosition(CodeModelItem item, AST *node);
 
+    void addQualifiedType(const QStringList &qualifiedName);
+    void addQualifiedTypes(ScopeModelItem scope);
+    int findQualifiedType(const QStringList &name, int contextId, QVector<int> *nameIds) const;
+
 private:
     CodeModel *_M_model;
     LocationManager &_M_location;
@@ -113,8 +133,26 @@ private:
     EnumModelItem _M_current_enum;
     QStringList _M_context;
     TemplateParameterList _M_current_template_parameters; // ### check me
-    QHash<QString, QString> _M_qualified_types;
+    // name table path ids of the declared types, and the number of types
+    // declared when a type with a given last name id was last declared
+    QSet<int> _M_qualified_types;
+    uint _M_qualified_types_revision;
+    QHash<int, uint> _M_qualified_name_revisions;
+    // qualifyType() results by (context, type) path id, -1 if unqualified,
+    // with the revisions they were found at and the name table ids of the
+    // context names looked up in the model
+    struct QualifyResult
+    {
+        int typeId;
+        uint qualifiedTypesRevision;
+        uint indexRevision;
+        QVector<int> nameIds;
+    };
+    mutable QHash<QPair<int, int>, QualifyResult> _M_qualify_cache;
+    // last anonymous enum number by scope, and the numbers left to reuse
+    // by (scope, file) for the re-parsed files
     QHash<QString, int> _M_anonymous_enums;
+    AnonymousEnumNumbers _M_reused_enum_numbers;
 
 protected:
     TypeCompiler type_cc;
@@ -29,15 +29,17 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/QStringList>
 
-#include <default_visitor.h>
+#include <static_visitor.h>
 #include <name_compiler.h>
 #include <type_compiler.h>
 
 class TokenStream;
 class Binder;
 
-class ClassCompiler: protected DefaultVisitor
+class ClassCompiler: protected StaticVisitor<ClassCompiler>
 {
+    friend class StaticVisitor<ClassCompiler>;
+
 public:
     ClassCompiler(Binder *binder);
     virtual ~ClassCompiler();
@@ -55,8 +57,8 @@ public:
     void run(ClassSpecifierAST *node);
 
 protected:
-    virtual void visitClassSpecifier(ClassSpecifierAST *node);
-    virtual void visitBaseSpecifier(BaseSpecifierAST *node);
+    void visitClassSpecifier(ClassSpecifierAST *node);
+    void visitBaseSpecifier(BaseSpecifierAST *node);
 
 private:
     Binder *_M_binder;
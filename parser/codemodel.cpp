@@ -27,20 +27,161 @@
 #include <algorithm>
 
 // ---------------------------------------------------------------------------
+CodeModelNameTable::CodeModelNameTable()
+{
+    _M_nameIds.insert(QString(), 0);
+    _M_names.append(QString());
+    _M_paths.append(QStringList());
+    _M_parentIds.append(0);
+    _M_pathNameIds.append(0);
+}
+
+QString CodeModelNameTable::intern(const QString &name)
+{
+    return _M_names.at(nameId(name));
+}
+
+QStringList CodeModelNameTable::intern(const QStringList &path)
+{
+    return _M_paths.at(pathId(path));
+}
+
+TypeInfo CodeModelNameTable::intern(const TypeInfo &type)
+{
+    TypeInfo result = type;
+    result.setQualifiedName(intern(type.qualifiedName()));
+
+    if (!type.arguments().isEmpty()) {
+        QList<TypeInfo> arguments;
+        foreach (const TypeInfo &argument, type.arguments())
+            arguments.append(intern(argument));
+        result.setArguments(arguments);
+    }
+
+    return result;
+}
+
+int CodeModelNameTable::nameId(const QString &name)
+{
+    QHash<QString, int>::const_iterator it = _M_nameIds.constFind(name);
+    if (it != _M_nameIds.constEnd())
+        return it.value();
+
+    int id = _M_names.size();
+    _M_names.append(name);
+    _M_nameIds.insert(name, id);
+    return id;
+}
+
+int CodeModelNameTable::pathId(const QStringList &path)
+{
+    int id = 0;
+    foreach (const QString &name, path)
+        id = pathId(id, nameId(name));
+    return id;
+}
+
+int CodeModelNameTable::pathId(int parent, const QString &name)
+{
+    return pathId(parent, nameId(name));
+}
+
+int CodeModelNameTable::pathId(int parent, int nameId)
+{
+    QPair<int, int> key(parent, nameId);
+
+    QHash<QPair<int, int>, int>::const_iterator it = _M_pathIds.constFind(key);
+    if (it != _M_pathIds.constEnd())
+        return it.value();
+
+    QStringList path = _M_paths.at(parent);
+    path.append(_M_names.at(nameId));
+
+    int id = _M_paths.size();
+    _M_paths.append(path);
+    _M_parentIds.append(parent);
+    _M_pathNameIds.append(nameId);
+    _M_pathIds.insert(key, id);
+    return id;
+}
+
+int CodeModelNameTable::findPathId(const QStringList &path, int parent) const
+{
+    int id = parent;
+    foreach (const QString &name, path) {
+        int nameId = _M_nameIds.value(name, -1);
+        if (nameId < 0)
+            return -1;
+        id = _M_pathIds.value(qMakePair(id, nameId), -1);
+        if (id < 0)
+            break;
+    }
+    return id;
+}
+
+// ---------------------------------------------------------------------------
+// What a qualified name resolves to in a scope, see resolveType(), with
+// the name table ids of the names looked up and the index revision the
+// lookup was made at.
+struct CodeModel::ResolvedName
+{
+    bool alias;
+    TypeInfo type;
+    uint revision;
+    QVector<int> nameIds;
+};
+
 CodeModel::CodeModel()
-        : _M_creation_id(0)
+        : _M_itemPool(new pool), _M_indexRootCount(0), _M_indexRevision(0), _M_clearRevision(0), _M_creation_id(0)
 {
     _M_globalNamespace = create<NamespaceModelItem>();
 }
 
 CodeModel::~CodeModel()
 {
+    // The handles left in the containers below are plain pointers and are
+    // not touched while these run; the pool then frees all items at once.
+    for (int i = _M_items.size() - 1; i >= 0; --i)
+        _M_items.at(i)->~_CodeModelItem();
+    delete _M_itemPool;
+}
+
+void CodeModel::releaseItems()
+{
+    _M_files.clear();
+    _M_itemIndex.clear();
+    _M_resolvedTypes.clear();
+    _M_globalNamespace = NamespaceModelItem();
+    _M_clearRevision = ++_M_indexRevision;
+
+    for (int i = _M_items.size() - 1; i >= 0; --i)
+        _M_items.at(i)->~_CodeModelItem();
+    _M_items.clear();
+    delete _M_itemPool;
+    _M_itemPool = new pool;
+
+    _M_globalNamespace = create<NamespaceModelItem>();
+}
+
+void *CodeModel::allocateItem(std::size_t size)
+{
+    // enough for any of the item members (pointers, ints, Qt containers)
+    static const std::size_t alignment = sizeof(void *) > sizeof(double) ? sizeof(void *) : sizeof(double);
+    return _M_itemPool->allocate(size, alignment);
+}
+
+void CodeModel::adoptItem(_CodeModelItem *item)
+{
+    _M_items.append(item);
 }
 
 void CodeModel::wipeout()
 {
     _M_globalNamespace = create<NamespaceModelItem>();
     _M_files.clear();
+    _M_itemIndex.clear();
+    _M_resolvedTypes.clear();
+    _M_clearRevision = ++_M_indexRevision;
 }
 
 FileList CodeModel::files() const
@@ -63,7 +204,7 @@ void CodeModel::removeFile(FileModelItem item)
 {
     QHash<QString, FileModelItem>::Iterator it = _M_files.find(item->name());
 
-    if (it != _M_files.end() && it.value() == item)
+    if (it != _M_files.end() && it.value() == item.data())
         _M_files.erase(it);
 }
 
@@ -72,13 +213,120 @@ FileModelItem CodeModel::findFile(const QString &name) const
     return _M_files.value(name);
 }
 
-QHash<QString, FileModelItem> CodeModel::fileMap() const
+const QHash<QString, FileModelItem> &CodeModel::fileMap() const
 {
     return _M_files;
 }
 
+void CodeModel::setIndexedItem(const QString &scopePath, const QString &name, CodeModelItem item)
+{
+    QString path = scopePath;
+    path += QLatin1String("::");
+    path += name;
+
+    QHash<QString, CodeModelItem>::iterator it = _M_itemIndex.find(path);
+    if (it == _M_itemIndex.end() ? !item : it.value() == item.data())
+        return;
+    if (!item)
+        _M_itemIndex.erase(it);
+    else if (it == _M_itemIndex.end())
+        _M_itemIndex.insert(path, item);
+    else
+        it.value() = item;
+
+    // A new or removed name may change how the names ending with it resolve.
+    int nameId = _M_nameTable.nameId(name);
+    if (nameId >= _M_nameRevisions.size())
+        _M_nameRevisions.resize(nameId + 1);
+    _M_nameRevisions[nameId] = ++_M_indexRevision;
+}
+
+QString CodeModel::createIndexRoot()
+{
+    return QString::fromLatin1("#%1").arg(_M_indexRootCount++);
+}
+
+// The resolved name applied to a type: a typedef chain is combined with
+// it, any other resolved name replaces its qualified name.
+static TypeInfo applyResolvedName(bool alias, const TypeInfo &resolved, const TypeInfo &type)
+{
+    if (alias)
+        return TypeInfo::combine(resolved, type);
+
+    TypeInfo result(type);
+    result.setQualifiedName(resolved.qualifiedName());
+    return result;
+}
+
+TypeInfo CodeModel::resolveType(const TypeInfo &type, CodeModelItem scope)
+{
+    ResolvedName resolved = resolveName(type.qualifiedName(), scope);
+    return applyResolvedName(resolved.alias, resolved.type, type);
+}
+
+CodeModel::ResolvedName CodeModel::resolveName(const QStringList &qualifiedName, CodeModelItem scope)
+{
+    // Only the qualified name takes part in the lookup, so what a name
+    // resolves to in a scope is computed once: either the qualified name
+    // of the item it refers to, or, for a typedef, the whole typedef chain
+    // combined into a single type. The latter is applied to a type as
+    //   resolve(alias, scope) combined with type
+    // which is what resolving combine(alias, type) step by step yields.
+    // A result stays valid until a name it looked up is indexed again.
+    QPair<const _CodeModelItem *, QString> key(scope.data(), qualifiedName.join("::"));
+    QHash<QPair<const _CodeModelItem *, QString>, ResolvedName>::const_iterator it = _M_resolvedTypes.constFind(key);
+    if (it != _M_resolvedTypes.constEnd()) {
+        bool current = true;
+        foreach (int nameId, it.value().nameIds)
+            current = current && nameRevision(nameId) <= it.value().revision;
+        if (current)
+            return it.value();
+    }
+
+    ResolvedName resolved;
+    resolved.revision = _M_indexRevision;
+    foreach (const QString &name, qualifiedName)
+        resolved.nameIds.append(_M_nameTable.nameId(name));
+
+    CodeModelItem item = findItem(qualifiedName, scope);
+    if (TypeAliasModelItem alias = model_dynamic_cast<TypeAliasModelItem>(item)) {
+        ResolvedName target = resolveName(alias->type().qualifiedName(), scope);
+        resolved.alias = true;
+        resolved.type = applyResolvedName(target.alias, target.type, alias->type());
+        resolved.nameIds += target.nameIds;
+    } else {
+        // Only replace the name if we actually got a resolved type with a
+        // namespace, i.e. the item has more than one name component.
+        resolved.alias = false;
+        if (item && item->qualifiedName().size() > 1)
+            resolved.type.setQualifiedName(item->qualifiedName());
+        else
+            resolved.type.setQualifiedName(qualifiedName);
+    }
+
+    _M_resolvedTypes.insert(key, resolved);
+    return resolved;
+}
+
 CodeModelItem CodeModel::findItem(const QStringList &qualifiedName, CodeModelItem scope) const
 {
+    if (qualifiedName.isEmpty())
+        return scope;
+
+    if (ScopeModelItem ss = model_dynamic_cast<ScopeModelItem>(scope)) {
+        QString path = ss->indexPath();
+        path += QLatin1String("::");
+        path += qualifiedName.join(QLatin1String("::"));
+        if (CodeModelItem item = _M_itemIndex.value(path))
+            return item;
+
+        // The index holds exactly what a single step of the walk below
+        // finds; only multi-part names (e.g. going through an enum or a
+        // template's short name) can still be found by walking.
+        if (qualifiedName.size() == 1)
+            return CodeModelItem();
+    }
+
     for (int i = 0; i < qualifiedName.size(); ++i) {
         // ### Extend to look for members etc too.
         const QString &name = qualifiedName.at(i);
@@ -130,22 +378,12 @@ TypeInfo TypeInfo::resolveType(TypeInfo const &__type, CodeModelItem __scope)
     CodeModel *__model = __scope->model();
     Q_ASSERT(__model != 0);
 
-    CodeModelItem __item = __model->findItem(__type.qualifiedName(), __scope);
-
-    // Copy the type and replace with the proper qualified name. This
-    // only makes sence to do if we're actually getting a resolved
-    // type with a namespace. We only get this if the returned type
-    // has more than 2 entries in the qualified name... This test
-    // could be improved by returning if the type was found or not.
-    TypeInfo otherType(__type);
-    if (__item && __item->qualifiedName().size() > 1) {
-        otherType.setQualifiedName(__item->qualifiedName());
-    }
-
-    if (TypeAliasModelItem __alias = model_dynamic_cast<TypeAliasModelItem> (__item))
-        return resolveType(TypeInfo::combine(__alias->type(), otherType), __scope);
+    return __model->resolveType(__type, __scope);
+}
 
-    return otherType;
+void TypeInfo::setArguments(const QList<TypeInfo> &arguments)
+{
+    m_arguments = arguments;
 }
 
 QString TypeInfo::toString() const
@@ -213,8 +451,13 @@ _CodeModelItem::_CodeModelItem(CodeModel *model, int kind)
         _M_startColumn(0),
         _M_endLine(0),
         _M_endColumn(0),
-        _M_creation_id(0)
+        _M_creation_id(0),
+        _M_nameId(0),
+        _M_fileNameId(0),
+        _M_scopeId(0),
+        _M_pathId(0)
 {
+    model->adoptItem(this);
 }
 
 _CodeModelItem::~_CodeModelItem()
@@ -238,42 +481,47 @@ void _CodeModelItem::setKind(int kind)
 
 QStringList _CodeModelItem::qualifiedName() const
 {
-    QStringList q = scope();
-
-    if (!name().isEmpty())
-        q += name();
+    return model()->nameTable()->path(_M_pathId);
+}
 
-    return q;
+void _CodeModelItem::updatePathId()
+{
+    if (_M_nameId == 0)
+        _M_pathId = _M_scopeId;
+    else
+        _M_pathId = model()->nameTable()->pathId(_M_scopeId, _M_nameId);
 }
 
 QString _CodeModelItem::name() const
 {
-    return _M_name;
+    return model()->nameTable()->name(_M_nameId);
 }
 
 void _CodeModelItem::setName(const QString &name)
 {
-    _M_name = name;
+    _M_nameId = model()->nameTable()->nameId(name);
+    updatePathId();
 }
 
 QStringList _CodeModelItem::scope() const
 {
-    return _M_scope;
+    return model()->nameTable()->path(_M_scopeId);
 }
 
 void _CodeModelItem::setScope(const QStringList &scope)
 {
-    _M_scope = scope;
+    _M_scopeId = model()->nameTable()->pathId(scope);
+    updatePathId();
 }
 
 QString _CodeModelItem::fileName() const
 {
-    return _M_fileName;
+    return model()->nameTable()->name(_M_fileNameId);
 }
 
 void _CodeModelItem::setFileName(const QString &fileName)
 {
-    _M_fileName = fileName;
+    _M_fileNameId = model()->nameTable()->nameId(fileName);
 }
 
 FileModelItem _CodeModelItem::file() const
@@ -306,17 +554,19 @@ void _CodeModelItem::setEndPosition(int line, int column)
 }
 
 // ---------------------------------------------------------------------------
-QStringList _ClassModelItem::baseClasses() const
+const QStringList &_ClassModelItem::baseClasses() const
 {
     return _M_baseClasses;
 }
 
 void _ClassModelItem::setBaseClasses(const QStringList &baseClasses)
 {
-    _M_baseClasses = baseClasses;
+    _M_baseClasses.clear();
+    foreach (const QString &baseClass, baseClasses)
+        _M_baseClasses.append(model()->nameTable()->intern(baseClass));
 }
 
-TemplateParameterList _ClassModelItem::templateParameters() const
+const TemplateParameterList &_ClassModelItem::templateParameters() const
 {
     return _M_templateParameters;
 }
@@ -409,13 +659,62 @@ EnumList _ScopeModelItem::enums() const
     return _M_enums.values();
 }
 
+void _ScopeModelItem::setIndexPath(const QString &path)
+{
+    if (_M_indexPath == path)
+        return;
+
+    QString oldPath = _M_indexPath;
+    _M_indexPath = path;
+
+    // Move the members indexed under the old path.
+    QSet<QString> names = _M_classes.keys().toSet()
+                          + _M_enums.keys().toSet()
+                          + _M_typeAliases.keys().toSet();
+    if ((kind() & Kind_Namespace) == Kind_Namespace)
+        names += static_cast<_NamespaceModelItem *>(this)->namespaceMap().keys().toSet();
+
+    foreach (QString name, names) {
+        model()->setIndexedItem(oldPath, name, CodeModelItem());
+        reindexMember(name);
+    }
+
+    foreach (ClassModelItem item, classes())
+        item->setIndexPath(path + QLatin1String("::") + item->name());
+
+    if ((kind() & Kind_Namespace) == Kind_Namespace) {
+        foreach (NamespaceModelItem item, static_cast<_NamespaceModelItem *>(this)->namespaces())
+            item->setIndexPath(path + QLatin1String("::") + item->name());
+    }
+}
+
+void _ScopeModelItem::reindexMember(const QString &name)
+{
+    // Same precedence as CodeModel::findItem().
+    CodeModelItem item;
+    if ((kind() & Kind_Namespace) == Kind_Namespace)
+        item = static_cast<_NamespaceModelItem *>(this)->findNamespace(name);
+    if (!item)
+        item = _M_classes.value(name);
+    if (!item)
+        item = _M_enums.value(name);
+    if (!item)
+        item = _M_typeAliases.value(name);
+
+    model()->setIndexedItem(indexPath(), name, item);
+}
+
 void _ScopeModelItem::addClass(ClassModelItem item)
 {
     QString name = item->name();
     int idx = name.indexOf("<");
-    if (idx > 0)
+    if (idx > 0) {
         _M_classes.insert(name.left(idx), item);
+        reindexMember(name.left(idx));
+    }
     _M_classes.insert(name, item);
+    reindexMember(name);
+    item->setIndexPath(indexPath() + QLatin1String("::") + name);
 }
 
 void _ScopeModelItem::addFunction(FunctionModelItem item)
@@ -436,19 +735,34 @@ void _ScopeModelItem::addVariable(VariableModelItem item)
 void _ScopeModelItem::addTypeAlias(TypeAliasModelItem item)
 {
     _M_typeAliases.insert(item->name(), item);
+    reindexMember(item->name());
 }
 
 void _ScopeModelItem::addEnum(EnumModelItem item)
 {
     _M_enums.insert(item->name(), item);
+    reindexMember(item->name());
 }
 
 void _ScopeModelItem::removeClass(ClassModelItem item)
 {
     QHash<QString, ClassModelItem>::Iterator it = _M_classes.find(item->name());
 
-    if (it != _M_classes.end() && it.value() == item)
+    if (it != _M_classes.end() && it.value() == item) {
         _M_classes.erase(it);
+        reindexMember(item->name());
+    }
+
+    // template classes are also listed under their short name
+    int idx = item->name().indexOf("<");
+    if (idx > 0) {
+        QString shortName = item->name().left(idx);
+        it = _M_classes.find(shortName);
+        if (it != _M_classes.end() && it.value() == item) {
+            _M_classes.erase(it);
+            reindexMember(shortName);
+        }
+    }
 }
 
 void _ScopeModelItem::removeFunction(FunctionModelItem item)
@@ -483,7 +797,7 @@ void _ScopeModelItem::removeVariable(VariableModelItem item)
 {
     QHash<QString, VariableModelItem>::Iterator it = _M_variables.find(item->name());
 
-    if (it != _M_variables.end() && it.value() == item)
+    if (it != _M_variables.end() && it.value() == item.data())
         _M_variables.erase(it);
 }
 
@@ -491,16 +805,20 @@ void _ScopeModelItem::removeTypeAlias(TypeAliasModelItem item)
 {
     QHash<QString, TypeAliasModelItem>::Iterator it = _M_typeAliases.find(item->name());
 
-    if (it != _M_typeAliases.end() && it.value() == item)
+    if (it != _M_typeAliases.end() && it.value() == item) {
         _M_typeAliases.erase(it);
+        reindexMember(item->name());
+    }
 }
 
 void _ScopeModelItem::removeEnum(EnumModelItem item)
 {
     QHash<QString, EnumModelItem>::Iterator it = _M_enums.find(item->name());
 
-    if (it != _M_enums.end() && it.value() == item)
+    if (it != _M_enums.end() && it.value() == item) {
         _M_enums.erase(it);
+        reindexMember(item->name());
+    }
 }
 
 ClassModelItem _ScopeModelItem::findClass(const QString &name) const
@@ -541,13 +859,17 @@ NamespaceList _NamespaceModelItem::namespaces() const
 void _NamespaceModelItem::addNamespace(NamespaceModelItem item)
 {
     _M_namespaces.insert(item->name(), item);
+    reindexMember(item->name());
+    item->setIndexPath(indexPath() + QLatin1String("::") + item->name());
 }
 void _NamespaceModelItem::removeNamespace(NamespaceModelItem item)
 {
     QHash<QString, NamespaceModelItem>::Iterator it = _M_namespaces.find(item->name());
 
-    if (it != _M_namespaces.end() && it.value() == item)
+    if (it != _M_namespaces.end() && it.value() == item) {
         _M_namespaces.erase(it);
+        reindexMember(item->name());
+    }
 }
 
 NamespaceModelItem _NamespaceModelItem::findNamespace(const QString &name) const
@@ -563,7 +885,7 @@ TypeInfo _ArgumentModelItem::type() const
 
 void _ArgumentModelItem::setType(const TypeInfo &type)
 {
-    _M_type = type;
+    _M_type = model()->nameTable()->intern(type);
 }
 
 bool _ArgumentModelItem::defaultValue() const
@@ -604,7 +926,7 @@ bool _FunctionModelItem::isSimilar(FunctionModelItem other) const
     return true;
 }
 
-ArgumentList _FunctionModelItem::arguments() const
+const ArgumentList &_FunctionModelItem::arguments() const
 {
     return _M_arguments;
 }
@@ -698,7 +1020,7 @@ TypeInfo _TypeAliasModelItem::type() const
 
 void _TypeAliasModelItem::setType(const TypeInfo &type)
 {
-    _M_type = type;
+    _M_type = model()->nameTable()->intern(type);
 }
 
 // ---------------------------------------------------------------------------
@@ -712,7 +1034,7 @@ void _EnumModelItem::setAccessPolicy(CodeModel::AccessPolicy accessPolicy)
     _M_accessPolicy = accessPolicy;
 }
 
-EnumeratorList _EnumModelItem::enumerators() const
+const EnumeratorList &_EnumModelItem::enumerators() const
 {
     return _M_enumerators;
 }
@@ -756,7 +1078,7 @@ TypeInfo _TemplateParameterModelItem::type() const
 
 void _TemplateParameterModelItem::setType(const TypeInfo &type)
 {
-    _M_type = type;
+    _M_type = model()->nameTable()->intern(type);
 }
 
 bool _TemplateParameterModelItem::defaultValue() const
@@ -772,73 +1094,73 @@ void _TemplateParameterModelItem::setDefaultValue(bool defaultValue)
 // ---------------------------------------------------------------------------
 ScopeModelItem _ScopeModelItem::create(CodeModel *model)
 {
-    ScopeModelItem item(new _ScopeModelItem(model));
+    ScopeModelItem item(new (model) _ScopeModelItem(model));
     return item;
 }
 
 ClassModelItem _ClassModelItem::create(CodeModel *model)
 {
-    ClassModelItem item(new _ClassModelItem(model));
+    ClassModelItem item(new (model) _ClassModelItem(model));
     return item;
 }
 
 NamespaceModelItem _NamespaceModelItem::create(CodeModel *model)
 {
-    NamespaceModelItem item(new _NamespaceModelItem(model));
+    NamespaceModelItem item(new (model) _NamespaceModelItem(model));
     return item;
 }
 
 FileModelItem _FileModelItem::create(CodeModel *model)
 {
-    FileModelItem item(new _FileModelItem(model));
+    FileModelItem item(new (model) _FileModelItem(model));
     return item;
 }
 
 ArgumentModelItem _ArgumentModelItem::create(CodeModel *model)
 {
-    ArgumentModelItem item(new _ArgumentModelItem(model));
+    ArgumentModelItem item(new (model) _ArgumentModelItem(model));
     return item;
 }
 
 FunctionModelItem _FunctionModelItem::create(CodeModel *model)
 {
-    FunctionModelItem item(new _FunctionModelItem(model));
+    FunctionModelItem item(new (model) _FunctionModelItem(model));
     return item;
 }
 
 FunctionDefinitionModelItem _FunctionDefinitionModelItem::create(CodeModel *model)
 {
-    FunctionDefinitionModelItem item(new _FunctionDefinitionModelItem(model));
+    FunctionDefinitionModelItem item(new (model) _FunctionDefinitionModelItem(model));
     return item;
 }
 
 VariableModelItem _VariableModelItem::create(CodeModel *model)
 {
-    VariableModelItem item(new _VariableModelItem(model));
+    VariableModelItem item(new (model) _VariableModelItem(model));
     return item;
 }
 
 TypeAliasModelItem _TypeAliasModelItem::create(CodeModel *model)
 {
-    TypeAliasModelItem item(new _TypeAliasModelItem(model));
+    TypeAliasModelItem item(new (model) _TypeAliasModelItem(model));
     return item;
 }
 
 EnumModelItem _EnumModelItem::create(CodeModel *model)
 {
-    EnumModelItem item(new _EnumModelItem(model));
+    EnumModelItem item(new (model) _EnumModelItem(model));
     return item;
 }
 
 EnumeratorModelItem _EnumeratorModelItem::create(CodeModel *model)
 {
-    EnumeratorModelItem item(new _EnumeratorModelItem(model));
+    EnumeratorModelItem item(new (model) _EnumeratorModelItem(model));
     return item;
 }
 
 TemplateParameterModelItem _TemplateParameterModelItem::create(CodeModel *model)
 {
-    TemplateParameterModelItem item(new _TemplateParameterModelItem(model));
+    TemplateParameterModelItem item(new (model) _TemplateParameterModelItem(model));
     return item;
 }
 
@@ -850,7 +1172,7 @@ TypeInfo _MemberModelItem::type() const
 
 void _MemberModelItem::setType(const TypeInfo &type)
 {
-    _M_type = type;
+    _M_type = model()->nameTable()->intern(type);
 }
 
 CodeModel::AccessPolicy _MemberModelItem::accessPolicy() const
@@ -28,9 +28,12 @@
 
 #include "codemodel_fwd.h"
 #include "codemodel_pointer.h"
+#include "smallobject.h"
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QVector>
@@ -48,6 +51,78 @@ _Target model_static_cast(_Source item)
     return ptr;
 }
 
+/**
+ * Interns the names, scopes and file names stored in a CodeModel.
+ *
+ * The same namespace and class names show up in the scope of thousands of
+ * model items and TypeInfos. The table numbers every distinct name and
+ * every distinct qualified path, so the items only store those ids, and
+ * hands out a single implicitly shared copy of each to the TypeInfos.
+ * Paths are kept as a trie of (parent path id, name id) pairs; id 0 is
+ * the empty name and the empty (global) path.
+ */
+class CodeModelNameTable
+{
+public:
+    CodeModelNameTable();
+
+    QString intern(const QString &name);
+    QStringList intern(const QStringList &path);
+    TypeInfo intern(const TypeInfo &type);
+
+    int nameId(const QString &name);
+
+    inline QString name(int id) const
+    {
+        return _M_names.at(id);
+    }
+
+    int pathId(const QStringList &path);
+    int pathId(int parent, const QString &name);
+    int pathId(int parent, int nameId);
+
+    // like pathId(), but returns -1 instead of adding unknown paths
+    int findPathId(const QStringList &path, int parent = 0) const;
+
+    inline QStringList path(int id) const
+    {
+        return _M_paths.at(id);
+    }
+
+    inline int parentPathId(int id) const
+    {
+        return _M_parentIds.at(id);
+    }
+
+    // the id of the last name of the path
+    inline int pathNameId(int id) const
+    {
+        return _M_pathNameIds.at(id);
+    }
+
+    inline int nameCount() const
+    {
+        return _M_names.size();
+    }
+
+    inline int pathCount() const
+    {
+        return _M_paths.size();
+    }
+
+private:
+    QHash<QString, int> _M_nameIds;
+    QVector<QString> _M_names;
+    QHash<QPair<int, int>, int> _M_pathIds;
+    QVector<QStringList> _M_paths;
+    QVector<int> _M_parentIds;
+    QVector<int> _M_pathNameIds;
+
+private:
+    CodeModelNameTable(const CodeModelNameTable &other);
+    void operator = (const CodeModelNameTable &other);
+};
+
 class CodeModel
 {
 public:
@@ -88,13 +163,85 @@ public:
     void addFile(FileModelItem item);
     void removeFile(FileModelItem item);
     FileModelItem findFile(const QString &name) const;
-    QHash<QString, FileModelItem> fileMap() const;
+    const QHash<QString, FileModelItem> &fileMap() const;
 
+    /// Only reads the model, so it may be called from several threads as
+    /// long as no other thread changes the model meanwhile.
     CodeModelItem findItem(const QStringList &qualifiedName, CodeModelItem scope) const;
 
+    /**
+     * Flat index of the namespaces, classes, enums and type aliases of all
+     * scopes, keyed by their "::" separated path from the outermost scope
+     * (see _ScopeModelItem::indexPath()). Kept up to date by the scopes as
+     * members are added or removed, it lets findItem() resolve a qualified
+     * name with a single hash lookup.
+     */
+    CodeModelItem findIndexedItem(const QString &path) const
+    {
+        return _M_itemIndex.value(path);
+    }
+    void setIndexedItem(const QString &scopePath, const QString &name, CodeModelItem item);
+    QString createIndexRoot();
+
+    // changes whenever the index does; lets callers validate derived caches
+    inline uint indexRevision() const
+    {
+        return _M_indexRevision;
+    }
+
+    // the index revision at which a member with the name of the name table
+    // id \p nameId was last added to or removed from some scope; only the
+    // lookups of that name may have changed since
+    inline uint nameRevision(int nameId) const
+    {
+        uint revision = nameId < _M_nameRevisions.size() ? _M_nameRevisions.at(nameId) : 0;
+        return qMax(revision, _M_clearRevision);
+    }
+
+    TypeInfo resolveType(const TypeInfo &type, CodeModelItem scope);
+
+    inline CodeModelNameTable *nameTable()
+    {
+        return &_M_nameTable;
+    }
+
     void wipeout();
 
+    /// Storage for a new item. Items are destroyed and their memory
+    /// released all at once, together with the model.
+    void *allocateItem(std::size_t size);
+
+    /// Destroys all items, leaving an empty model that keeps its name
+    /// table, e.g. to bind a long input piece by piece.
+    void releaseItems();
+
+    /// The creation id the next item gets; the items created after this
+    /// call have at least this id, until addFile() starts over at 0.
+    inline std::size_t nextCreationId() const
+    {
+        return _M_creation_id;
+    }
+
+private:
+    friend class _CodeModelItem;
+    void adoptItem(_CodeModelItem *item);
+
+    struct ResolvedName;
+    ResolvedName resolveName(const QStringList &qualifiedName, CodeModelItem scope);
+
 private:
+    pool *_M_itemPool;
+    QVector<_CodeModelItem *> _M_items;
+    CodeModelNameTable _M_nameTable;
+    QHash<QString, CodeModelItem> _M_itemIndex;
+    int _M_indexRootCount;
+    uint _M_indexRevision;
+    // index revisions of the last change by member name id, and of the
+    // last time the whole index was cleared
+    QVector<uint> _M_nameRevisions;
+    uint _M_clearRevision;
+    // Flattened typedef chains by (scope, qualified name); see resolveType().
+    QHash<QPair<const _CodeModelItem *, QString>, ResolvedName> _M_resolvedTypes;
     QHash<QString, FileModelItem> _M_files;
     NamespaceModelItem _M_globalNamespace;
     std::size_t _M_creation_id;
@@ -117,7 +264,7 @@ public:
     TypeInfo():
             flags(0) {}
 
-    QStringList qualifiedName() const
+    const QStringList &qualifiedName() const
     {
         return m_qualifiedName;
     }
@@ -176,7 +323,7 @@ public:
         m_functionPointer = is;
     }
 
-    QStringList arrayElements() const
+    const QStringList &arrayElements() const
     {
         return m_arrayElements;
     }
@@ -185,7 +332,7 @@ public:
         m_arrayElements = arrayElements;
     }
 
-    QList<TypeInfo> arguments() const
+    const QList<TypeInfo> &arguments() const
     {
         return m_arguments;
     }
@@ -259,6 +406,8 @@ public:
 
     int kind() const;
 
+    // a shared copy of the interned path in the name table; no list is
+    // built per call
     QStringList qualifiedName() const;
 
     QString name() const;
@@ -295,10 +444,21 @@ public:
 
     CodeModelItem toItem() const;
 
+    static void *operator new(std::size_t size, CodeModel *model)
+    {
+        return model->allocateItem(size);
+    }
+
 protected:
     _CodeModelItem(CodeModel *model, int kind);
     void setKind(int kind);
 
+    // Items are only destroyed by their model, which owns their memory.
+    static void operator delete(void *) {}
+
+private:
+    void updatePathId();
+
 private:
     CodeModel *_M_model;
     int _M_kind;
@@ -307,9 +467,11 @@ private:
     int _M_endLine;
     int _M_endColumn;
     std::size_t _M_creation_id;
-    QString _M_name;
-    QString _M_fileName;
-    QStringList _M_scope;
+    // ids in the model's name table
+    int _M_nameId;
+    int _M_fileNameId;
+    int _M_scopeId;
+    int _M_pathId;
 
 private:
     _CodeModelItem(const _CodeModelItem &other);
@@ -353,41 +515,54 @@ public:
     VariableModelItem findVariable(const QString &name) const;
 
     void addEnumsDeclaration(const QString &enumsDeclaration);
-    QStringList enumsDeclarations() const
+    const QStringList &enumsDeclarations() const
     {
         return _M_enumsDeclarations;
     }
 
-    inline QHash<QString, ClassModelItem> classMap() const
+    inline const QHash<QString, ClassModelItem> &classMap() const
     {
         return _M_classes;
     }
-    inline QHash<QString, EnumModelItem> enumMap() const
+    inline const QHash<QString, EnumModelItem> &enumMap() const
     {
         return _M_enums;
     }
-    inline QHash<QString, TypeAliasModelItem> typeAliasMap() const
+    inline const QHash<QString, TypeAliasModelItem> &typeAliasMap() const
     {
         return _M_typeAliases;
     }
-    inline QHash<QString, VariableModelItem> variableMap() const
+    inline const QHash<QString, VariableModelItem> &variableMap() const
     {
         return _M_variables;
     }
-    inline QMultiHash<QString, FunctionDefinitionModelItem> functionDefinitionMap() const
+    inline const QMultiHash<QString, FunctionDefinitionModelItem> &functionDefinitionMap() const
     {
         return _M_functionDefinitions;
     }
-    inline QMultiHash<QString, FunctionModelItem> functionMap() const
+    inline const QMultiHash<QString, FunctionModelItem> &functionMap() const
     {
         return _M_functions;
     }
 
     FunctionModelItem declaredFunction(FunctionModelItem item);
 
+    /// Path of this scope in the model's item index. Scopes not (yet)
+    /// added to another scope have a unique root path.
+    inline QString indexPath() const
+    {
+        return _M_indexPath;
+    }
+
 protected:
+    // The root path is assigned right away so that indexPath(), and with
+    // it CodeModel::findItem(), never modify the model.
     _ScopeModelItem(CodeModel *model, int kind = __node_kind)
-            : _CodeModelItem(model, kind) {}
+            : _CodeModelItem(model, kind),
+            _M_indexPath(model->createIndexRoot()) {}
+
+    void setIndexPath(const QString &path);
+    void reindexMember(const QString &name);
 
 private:
     QHash<QString, ClassModelItem> _M_classes;
@@ -402,6 +577,7 @@ private:
     void operator = (const _ScopeModelItem &other);
 
     QStringList _M_enumsDeclarations;
+    QString _M_indexPath;
 };
 
 class _ClassModelItem: public _ScopeModelItem
@@ -412,13 +588,13 @@ public:
     static ClassModelItem create(CodeModel *model);
 
 public:
-    QStringList baseClasses() const;
+    const QStringList &baseClasses() const;
 
     void setBaseClasses(const QStringList &baseClasses);
     void addBaseClass(const QString &baseClass);
     void removeBaseClass(const QString &baseClass);
 
-    TemplateParameterList templateParameters() const;
+    const TemplateParameterList &templateParameters() const;
     void setTemplateParameters(const TemplateParameterList &templateParameters);
 
     bool extendsClass(const QString &name) const;
@@ -427,7 +603,7 @@ public:
     CodeModel::ClassType classType() const;
 
     void addPropertyDeclaration(const QString &propertyDeclaration);
-    QStringList propertyDeclarations() const
+    const QStringList &propertyDeclarations() const
     {
         return _M_propertyDeclarations;
     }
@@ -463,7 +639,7 @@ public:
 
     NamespaceModelItem findNamespace(const QString &name) const;
 
-    inline QHash<QString, NamespaceModelItem> namespaceMap() const
+    inline const QHash<QString, NamespaceModelItem> &namespaceMap() const
     {
         return _M_namespaces;
     };
@@ -566,7 +742,7 @@ public:
     CodeModel::AccessPolicy accessPolicy() const;
     void setAccessPolicy(CodeModel::AccessPolicy accessPolicy);
 
-    TemplateParameterList templateParameters() const
+    const TemplateParameterList &templateParameters() const
     {
         return _M_templateParameters;
     }
@@ -613,7 +789,7 @@ public:
     static FunctionModelItem create(CodeModel *model);
 
 public:
-    ArgumentList arguments() const;
+    const ArgumentList &arguments() const;
 
     void addArgument(ArgumentModelItem item);
     void removeArgument(ArgumentModelItem item);
@@ -733,7 +909,7 @@ public:
     CodeModel::AccessPolicy accessPolicy() const;
     void setAccessPolicy(CodeModel::AccessPolicy accessPolicy);
 
-    EnumeratorList enumerators() const;
+    const EnumeratorList &enumerators() const;
     void addEnumerator(EnumeratorModelItem item);
     void removeEnumerator(EnumeratorModelItem item);
     bool isAnonymous() const;
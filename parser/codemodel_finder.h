@@ -26,15 +26,17 @@
 #ifndef CODEMODEL_FINDER_H
 #define CODEMODEL_FINDER_H
 
-#include <default_visitor.h>
+#include <static_visitor.h>
 #include <codemodel_fwd.h>
 #include <name_compiler.h>
 
 class TokenStream;
 class Binder;
 
-class CodeModelFinder: protected DefaultVisitor
+class CodeModelFinder: protected StaticVisitor<CodeModelFinder>
 {
+    friend class StaticVisitor<CodeModelFinder>;
+
     enum ResolvePolicy {
         ResolveScope,
         ResolveItem
@@ -52,8 +54,8 @@ public:
     }
 
 protected:
-    virtual void visitName(NameAST *node);
-    virtual void visitUnqualifiedName(UnqualifiedNameAST *node);
+    void visitName(NameAST *node);
+    void visitUnqualifiedName(UnqualifiedNameAST *node);
 
     ScopeModelItem changeCurrentScope(ScopeModelItem scope);
 
@@ -0,0 +1,309 @@
+/*
+ * This file is part of the API Extractor project.
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "codemodel_partition.h"
+#include "binder.h"
+#include "control.h"
+#include "parser.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QtAlgorithms>
+
+#include <cctype>
+
+// Returns the file named by the '# line "file"' marker starting at
+// @p cursor, or a null string if the line is no marker.
+static QString markerFileName(const char *cursor, const char *end)
+{
+    if (cursor == end || *cursor++ != '#')
+        return QString();
+
+    while (cursor != end && (*cursor == ' ' || *cursor == '\t'))
+        ++cursor;
+    if (cursor == end || !std::isdigit((unsigned char) *cursor))
+        return QString();
+    while (cursor != end && std::isdigit((unsigned char) *cursor))
+        ++cursor;
+    while (cursor != end && (*cursor == ' ' || *cursor == '\t'))
+        ++cursor;
+    if (cursor == end || *cursor++ != '"')
+        return QString();
+
+    const char *name = cursor;
+    while (cursor != end && *cursor != '"' && *cursor != '\n')
+        ++cursor;
+    if (cursor == end || *cursor != '"')
+        return QString();
+
+    return QString::fromLocal8Bit(name, int(cursor - name));
+}
+
+CodeModelPartition::CodeModelPartition(const QByteArray &contents)
+        : m_contents(contents), m_selfContained(true)
+{
+    const char *begin = m_contents.constData();
+    const char *end = begin + m_contents.size();
+
+    Run run;
+    run.begin = 0;
+
+    for (const char *line = begin; line != end;) {
+        const char *next = line;
+        while (next != end && *next++ != '\n')
+            ;
+
+        QString fileName = markerFileName(line, next);
+        if (!fileName.isNull() && fileName != run.fileName) {
+            run.end = int(line - begin);
+            if (run.end > run.begin)
+                m_runs.append(run);
+            run.fileName = fileName;
+            run.begin = run.end;
+        }
+        line = next;
+    }
+    run.end = m_contents.size();
+    if (run.end > run.begin)
+        m_runs.append(run);
+
+    QHash<QString, QCryptographicHash *> hashes;
+    foreach (const Run &r, m_runs) {
+        QCryptographicHash *&hash = hashes[r.fileName];
+        if (!hash)
+            hash = new QCryptographicHash(QCryptographicHash::Sha1);
+        hash->addData(begin + r.begin, r.end - r.begin);
+
+        if (m_selfContained)
+            m_selfContained = isBalanced(begin + r.begin, begin + r.end);
+    }
+
+    for (QHash<QString, QCryptographicHash *>::const_iterator it = hashes.begin(); it != hashes.end(); ++it)
+        m_fingerprints.insert(it.key(), it.value()->result());
+    qDeleteAll(hashes);
+}
+
+bool CodeModelPartition::isSelfContained() const
+{
+    return m_selfContained;
+}
+
+const CodeModelPartition::FingerprintMap &CodeModelPartition::fingerprints() const
+{
+    return m_fingerprints;
+}
+
+QByteArray CodeModelPartition::extract(const QSet<QString> &fileNames) const
+{
+    QByteArray result;
+    foreach (const Run &r, m_runs) {
+        if (fileNames.contains(r.fileName))
+            result.append(m_contents.constData() + r.begin, r.end - r.begin);
+    }
+    return result;
+}
+
+bool CodeModelPartition::isBalanced(const char *begin, const char *end)
+{
+    int braces = 0;
+    int parens = 0;
+    char last = 0;
+    bool lineStart = true;
+
+    for (const char *cursor = begin; cursor != end; ++cursor) {
+        char c = *cursor;
+        if (lineStart && c == '#') {
+            // line markers and left over directives
+            while (cursor + 1 != end && cursor[1] != '\n')
+                ++cursor;
+            continue;
+        }
+        lineStart = (c == '\n');
+
+        switch (c) {
+        case '"':
+        case '\'':
+            while (++cursor != end && *cursor != c) {
+                if (*cursor == '\\' && cursor + 1 != end)
+                    ++cursor;
+            }
+            if (cursor == end)
+                return false;
+            break;
+        case '{':
+            ++braces;
+            break;
+        case '}':
+            if (--braces < 0)
+                return false;
+            break;
+        case '(':
+            ++parens;
+            break;
+        case ')':
+            if (--parens < 0)
+                return false;
+            break;
+        }
+
+        if (!std::isspace((unsigned char) c))
+            last = c;
+    }
+
+    return braces == 0 && parens == 0 && (last == 0 || last == ';' || last == '}');
+}
+
+void CodeModelPartition::removeItems(ScopeModelItem scope, const QSet<QString> &fileNames,
+                                     QHash<QPair<QString, QString>, QList<int> > *enumNumbers)
+{
+    ClassList classes;
+    const QHash<QString, ClassModelItem> &classMap = scope->classMap();
+    for (QHash<QString, ClassModelItem>::const_iterator it = classMap.begin(); it != classMap.end(); ++it) {
+        if (it.key() != it.value()->name())
+            continue;
+        if (fileNames.contains(it.value()->fileName()))
+            classes.append(it.value());
+        else // out of line member definitions
+            removeItems(model_static_cast<ScopeModelItem>(it.value()), fileNames, enumNumbers);
+    }
+    foreach (ClassModelItem item, classes)
+        scope->removeClass(item);
+
+    QString scopeName = scope->qualifiedName().join("::");
+    foreach (EnumModelItem item, scope->enums()) {
+        if (!fileNames.contains(item->fileName()))
+            continue;
+        if (item->isAnonymous()) {
+            int number = item->name().mid(5).toInt(); // "enum_<number>"
+            QList<int> &numbers = (*enumNumbers)[qMakePair(scopeName, item->fileName())];
+            numbers.insert(qLowerBound(numbers.begin(), numbers.end(), number) - numbers.begin(), number);
+        }
+        scope->removeEnum(item);
+    }
+    foreach (TypeAliasModelItem item, scope->typeAliases()) {
+        if (fileNames.contains(item->fileName()))
+            scope->removeTypeAlias(item);
+    }
+    foreach (VariableModelItem item, scope->variables()) {
+        if (fileNames.contains(item->fileName()))
+            scope->removeVariable(item);
+    }
+    foreach (FunctionModelItem item, scope->functions()) {
+        if (fileNames.contains(item->fileName()))
+            scope->removeFunction(item);
+    }
+    foreach (FunctionDefinitionModelItem item, scope->functionDefinitions()) {
+        if (fileNames.contains(item->fileName()))
+            scope->removeFunctionDefinition(item);
+    }
+
+    NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(scope);
+    if (!ns)
+        return;
+
+    foreach (NamespaceModelItem inner, ns->namespaces()) {
+        removeItems(model_static_cast<ScopeModelItem>(inner), fileNames, enumNumbers);
+
+        // a namespace opened by a changed file is recreated when the file
+        // still opens it, unless other files keep it alive
+        if (fileNames.contains(inner->fileName())
+            && inner->classMap().isEmpty() && inner->enumMap().isEmpty()
+            && inner->typeAliasMap().isEmpty() && inner->variableMap().isEmpty()
+            && inner->functionMap().isEmpty() && inner->functionDefinitionMap().isEmpty()
+            && inner->namespaceMap().isEmpty()) {
+            ns->removeNamespace(inner);
+        }
+    }
+}
+
+void CodeModelPartition::collectTypes(ScopeModelItem scope, const QSet<QString> &fileNames, QSet<QString> *types)
+{
+    const QHash<QString, ClassModelItem> &classMap = scope->classMap();
+    for (QHash<QString, ClassModelItem>::const_iterator it = classMap.begin(); it != classMap.end(); ++it) {
+        if (it.key() != it.value()->name())
+            continue;
+        if (fileNames.contains(it.value()->fileName()))
+            types->insert(it.value()->qualifiedName().join("::"));
+        collectTypes(model_static_cast<ScopeModelItem>(it.value()), fileNames, types);
+    }
+
+    foreach (EnumModelItem item, scope->enums()) {
+        if (fileNames.contains(item->fileName()))
+            types->insert(item->qualifiedName().join("::"));
+    }
+    foreach (TypeAliasModelItem item, scope->typeAliases()) {
+        if (fileNames.contains(item->fileName()))
+            types->insert(item->qualifiedName().join("::"));
+    }
+
+    if (NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(scope)) {
+        foreach (NamespaceModelItem inner, ns->namespaces())
+            collectTypes(model_static_cast<ScopeModelItem>(inner), fileNames, types);
+    }
+}
+
+bool CodeModelPartition::update(FileModelItem file, const FingerprintMap &previous) const
+{
+    if (!m_selfContained)
+        return false;
+
+    QSet<QString> changed;
+    for (FingerprintMap::const_iterator it = m_fingerprints.begin(); it != m_fingerprints.end(); ++it) {
+        if (previous.value(it.key()) != it.value())
+            changed.insert(it.key());
+    }
+    for (FingerprintMap::const_iterator it = previous.begin(); it != previous.end(); ++it) {
+        if (!m_fingerprints.contains(it.key()))
+            changed.insert(it.key());
+    }
+
+    if (changed.isEmpty())
+        return true;
+
+    // text before the first line marker can't be parsed on its own
+    if (changed.contains(QString()))
+        return false;
+
+    ScopeModelItem scope = model_static_cast<ScopeModelItem>(file);
+    QSet<QString> typesBefore;
+    collectTypes(scope, changed, &typesBefore);
+    Binder::AnonymousEnumNumbers enumNumbers;
+    removeItems(scope, changed, &enumNumbers);
+
+    QByteArray contents = extract(changed);
+    if (!contents.isEmpty()) {
+        Control control;
+        Parser p(&control);
+        pool __pool;
+
+        TranslationUnitAST *ast = p.parse(contents, contents.size(), &__pool);
+
+        Binder binder(file->model(), p.location());
+        binder.run(ast, file, enumNumbers);
+    }
+
+    // The unchanged files were qualified against the types declared by the
+    // changed ones, so those must not have been added or removed.
+    QSet<QString> typesAfter;
+    collectTypes(scope, changed, &typesAfter);
+    return typesBefore == typesAfter;
+}
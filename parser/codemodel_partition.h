@@ -0,0 +1,89 @@
+/*
+ * This file is part of the API Extractor project.
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef CODEMODEL_PARTITION_H
+#define CODEMODEL_PARTITION_H
+
+#include "codemodel.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+
+/**
+ * Splits a preprocessed translation unit by originating file.
+ *
+ * The preprocessor precedes every output line with a '# line "file"'
+ * marker, so each byte of the input can be attributed to the header it
+ * came from. A partition keeps the runs of consecutive lines coming from
+ * the same file and a fingerprint of every file's share of the input.
+ *
+ * update() uses them to bring a previously bound model up to date: the
+ * items of the files whose fingerprint changed are removed and only the
+ * runs of those files are parsed and bound again into the old model.
+ */
+class CodeModelPartition
+{
+public:
+    typedef QHash<QString, QByteArray> FingerprintMap;
+
+    explicit CodeModelPartition(const QByteArray &contents);
+
+    /// True if every run starts and ends between two declarations,
+    /// i.e. no header is included from within a class or function body
+    /// and braces are balanced inside each run.
+    bool isSelfContained() const;
+
+    const FingerprintMap &fingerprints() const;
+
+    /// Returns the runs of @p fileNames, in input order, as a new
+    /// translation unit.
+    QByteArray extract(const QSet<QString> &fileNames) const;
+
+    /// Re-binds into @p file the files whose fingerprint differs from
+    /// @p previous, which must be the fingerprints @p file was bound with.
+    /// Returns false if the model could not be updated in place; @p file
+    /// is then left in an undefined state and must be rebuilt from scratch.
+    bool update(FileModelItem file, const FingerprintMap &previous) const;
+
+private:
+    struct Run
+    {
+        QString fileName;
+        int begin;
+        int end;
+    };
+
+    static bool isBalanced(const char *begin, const char *end);
+    // also records the numbers of the removed anonymous enums by scope and
+    // file, see Binder::run()
+    static void removeItems(ScopeModelItem scope, const QSet<QString> &fileNames,
+                            QHash<QPair<QString, QString>, QList<int> > *enumNumbers);
+    static void collectTypes(ScopeModelItem scope, const QSet<QString> &fileNames, QSet<QString> *types);
+
+    QByteArray m_contents;
+    QList<Run> m_runs;
+    FingerprintMap m_fingerprints;
+    bool m_selfContained;
+};
+
+#endif // CODEMODEL_PARTITION_H
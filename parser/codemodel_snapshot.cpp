@@ -0,0 +1,388 @@
+/*
+ * This file is part of the API Extractor project.
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "codemodel_snapshot.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QIODevice>
+
+// "CMSN"
+static const quint32 SNAPSHOT_MAGIC = 0x434d534e;
+// Bump whenever the CodeModel or the layout below changes.
+static const quint32 SNAPSHOT_VERSION = 3;
+
+CodeModelSnapshot::CodeModelSnapshot(QIODevice *device, CodeModel *model)
+        : m_stream(device), m_model(model)
+{
+    m_stream.setVersion(QDataStream::Qt_4_5);
+}
+
+QByteArray CodeModelSnapshot::fingerprint(const QByteArray &input)
+{
+    return QCryptographicHash::hash(input, QCryptographicHash::Sha1);
+}
+
+bool CodeModelSnapshot::save(QIODevice *device, FileModelItem file, const QByteArray &fingerprint,
+                             const QHash<QString, QByteArray> &partitions)
+{
+    CodeModelSnapshot snapshot(device);
+    snapshot.m_stream << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << fingerprint << partitions;
+    snapshot.writeItem(model_static_cast<CodeModelItem>(file));
+    return snapshot.m_stream.status() == QDataStream::Ok;
+}
+
+FileModelItem CodeModelSnapshot::load(QIODevice *device, CodeModel *model, const QByteArray &fingerprint,
+                                      QHash<QString, QByteArray> *partitions)
+{
+    CodeModelSnapshot snapshot(device, model);
+
+    quint32 magic, version;
+    QByteArray storedFingerprint;
+    snapshot.m_stream >> magic >> version;
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+        return FileModelItem();
+
+    snapshot.m_stream >> storedFingerprint;
+    if (!fingerprint.isEmpty() && storedFingerprint != fingerprint)
+        return FileModelItem();
+
+    QHash<QString, QByteArray> storedPartitions;
+    snapshot.m_stream >> storedPartitions;
+    if (partitions)
+        *partitions = storedPartitions;
+
+    CodeModelItem item = snapshot.readItem();
+    if (snapshot.m_stream.status() != QDataStream::Ok)
+        return FileModelItem();
+
+    return model_safe_cast<FileModelItem>(item);
+}
+
+void CodeModelSnapshot::writeItem(CodeModelItem item)
+{
+    if (!item) {
+        m_stream << qint32(-1);
+        return;
+    }
+
+    QHash<const _CodeModelItem *, qint32>::const_iterator it = m_writtenItems.constFind(item.data());
+    if (it != m_writtenItems.constEnd()) {
+        m_stream << it.value();
+        return;
+    }
+
+    qint32 id = m_writtenItems.size();
+    m_writtenItems.insert(item.data(), id);
+    m_stream << id << qint32(item->kind());
+
+    int startLine, startColumn, endLine, endColumn;
+    item->getStartPosition(&startLine, &startColumn);
+    item->getEndPosition(&endLine, &endColumn);
+    m_stream << item->name() << item->scope() << item->fileName()
+             << qint32(startLine) << qint32(startColumn)
+             << qint32(endLine) << qint32(endColumn);
+
+    if (ScopeModelItem scope = model_dynamic_cast<ScopeModelItem>(item))
+        writeScope(scope);
+
+    if (NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(item))
+        writeItemList(ns->namespaces());
+
+    if (ClassModelItem klass = model_dynamic_cast<ClassModelItem>(item)) {
+        m_stream << klass->baseClasses() << qint32(klass->classType())
+                 << klass->propertyDeclarations();
+        writeItemList(klass->templateParameters());
+    }
+
+    if (MemberModelItem member = model_dynamic_cast<MemberModelItem>(item)) {
+        writeTypeInfo(member->type());
+        writeItemList(member->templateParameters());
+        m_stream << qint32(member->accessPolicy())
+                 << member->isConstant() << member->isVolatile()
+                 << member->isStatic() << member->isAuto()
+                 << member->isFriend() << member->isRegister()
+                 << member->isExtern() << member->isMutable();
+    }
+
+    if (FunctionModelItem function = model_dynamic_cast<FunctionModelItem>(item)) {
+        writeItemList(function->arguments());
+        m_stream << qint32(function->functionType())
+                 << function->isVirtual() << function->isInline()
+                 << function->isExplicit() << function->isInvokable()
+                 << function->isAbstract() << function->isVariadics();
+    }
+
+    if (ArgumentModelItem argument = model_dynamic_cast<ArgumentModelItem>(item)) {
+        writeTypeInfo(argument->type());
+        m_stream << argument->defaultValue() << argument->defaultValueExpression();
+    }
+
+    if (TypeAliasModelItem alias = model_dynamic_cast<TypeAliasModelItem>(item))
+        writeTypeInfo(alias->type());
+
+    if (EnumModelItem enumItem = model_dynamic_cast<EnumModelItem>(item)) {
+        m_stream << qint32(enumItem->accessPolicy()) << enumItem->isAnonymous();
+        writeItemList(enumItem->enumerators());
+    }
+
+    if (EnumeratorModelItem enumerator = model_dynamic_cast<EnumeratorModelItem>(item))
+        m_stream << enumerator->value();
+
+    if (TemplateParameterModelItem parameter = model_dynamic_cast<TemplateParameterModelItem>(item)) {
+        writeTypeInfo(parameter->type());
+        m_stream << parameter->defaultValue();
+    }
+}
+
+void CodeModelSnapshot::writeScope(ScopeModelItem item)
+{
+    writeItemList(item->classes());
+    writeItemList(item->enums());
+    writeItemList(item->typeAliases());
+    writeItemList(item->variables());
+    writeItemMultiHash(item->functionDefinitionMap());
+    writeItemMultiHash(item->functionMap());
+    m_stream << item->enumsDeclarations();
+}
+
+void CodeModelSnapshot::writeTypeInfo(const TypeInfo &type)
+{
+    m_stream << type.qualifiedName() << type.arrayElements()
+             << type.isConstant() << type.isVolatile()
+             << type.isReference() << type.isFunctionPointer()
+             << qint32(type.indirections());
+
+    QList<TypeInfo> arguments = type.arguments();
+    m_stream << qint32(arguments.size());
+    foreach (const TypeInfo &argument, arguments)
+        writeTypeInfo(argument);
+}
+
+CodeModelItem CodeModelSnapshot::createItem(int kind)
+{
+    switch (kind) {
+    case _CodeModelItem::Kind_Scope:
+        return m_model->create<ScopeModelItem>()->toItem();
+    case _CodeModelItem::Kind_Namespace:
+        return m_model->create<NamespaceModelItem>()->toItem();
+    case _CodeModelItem::Kind_File:
+        return m_model->create<FileModelItem>()->toItem();
+    case _CodeModelItem::Kind_Class:
+        return m_model->create<ClassModelItem>()->toItem();
+    case _CodeModelItem::Kind_Function:
+        return m_model->create<FunctionModelItem>()->toItem();
+    case _CodeModelItem::Kind_FunctionDefinition:
+        return m_model->create<FunctionDefinitionModelItem>()->toItem();
+    case _CodeModelItem::Kind_Variable:
+        return m_model->create<VariableModelItem>()->toItem();
+    case _CodeModelItem::Kind_Argument:
+        return m_model->create<ArgumentModelItem>()->toItem();
+    case _CodeModelItem::Kind_TypeAlias:
+        return m_model->create<TypeAliasModelItem>()->toItem();
+    case _CodeModelItem::Kind_Enum:
+        return m_model->create<EnumModelItem>()->toItem();
+    case _CodeModelItem::Kind_Enumerator:
+        return m_model->create<EnumeratorModelItem>()->toItem();
+    case _CodeModelItem::Kind_TemplateParameter:
+        return m_model->create<TemplateParameterModelItem>()->toItem();
+    default:
+        return CodeModelItem();
+    }
+}
+
+CodeModelItem CodeModelSnapshot::readItem()
+{
+    qint32 id;
+    m_stream >> id;
+    if (id < 0 || m_stream.status() != QDataStream::Ok)
+        return CodeModelItem();
+
+    if (id < m_readItems.size())
+        return m_readItems.at(id);
+
+    qint32 kind;
+    m_stream >> kind;
+
+    CodeModelItem item;
+    if (id == m_readItems.size())
+        item = createItem(kind);
+
+    if (!item) {
+        m_stream.setStatus(QDataStream::ReadCorruptData);
+        return CodeModelItem();
+    }
+    m_readItems.append(item);
+
+    QString name, fileName;
+    QStringList scope;
+    qint32 startLine, startColumn, endLine, endColumn;
+    m_stream >> name >> scope >> fileName
+             >> startLine >> startColumn >> endLine >> endColumn;
+    item->setName(name);
+    item->setScope(scope);
+    item->setFileName(fileName);
+    item->setStartPosition(startLine, startColumn);
+    item->setEndPosition(endLine, endColumn);
+
+    if (ScopeModelItem scopeItem = model_dynamic_cast<ScopeModelItem>(item))
+        readScope(scopeItem);
+
+    if (NamespaceModelItem ns = model_dynamic_cast<NamespaceModelItem>(item)) {
+        foreach (NamespaceModelItem child, readItemList<NamespaceModelItem>())
+            ns->addNamespace(child);
+    }
+
+    if (ClassModelItem klass = model_dynamic_cast<ClassModelItem>(item)) {
+        QStringList baseClasses, propertyDeclarations;
+        qint32 classType;
+        m_stream >> baseClasses >> classType >> propertyDeclarations;
+        klass->setBaseClasses(baseClasses);
+        klass->setClassType(CodeModel::ClassType(classType));
+        foreach (QString propertyDeclaration, propertyDeclarations)
+            klass->addPropertyDeclaration(propertyDeclaration);
+        klass->setTemplateParameters(readItemList<TemplateParameterModelItem>());
+    }
+
+    if (MemberModelItem member = model_dynamic_cast<MemberModelItem>(item)) {
+        member->setType(readTypeInfo());
+        member->setTemplateParameters(readItemList<TemplateParameterModelItem>());
+
+        qint32 accessPolicy;
+        bool isConstant, isVolatile, isStatic, isAuto;
+        bool isFriend, isRegister, isExtern, isMutable;
+        m_stream >> accessPolicy
+                 >> isConstant >> isVolatile >> isStatic >> isAuto
+                 >> isFriend >> isRegister >> isExtern >> isMutable;
+        member->setAccessPolicy(CodeModel::AccessPolicy(accessPolicy));
+        member->setConstant(isConstant);
+        member->setVolatile(isVolatile);
+        member->setStatic(isStatic);
+        member->setAuto(isAuto);
+        member->setFriend(isFriend);
+        member->setRegister(isRegister);
+        member->setExtern(isExtern);
+        member->setMutable(isMutable);
+    }
+
+    if (FunctionModelItem function = model_dynamic_cast<FunctionModelItem>(item)) {
+        foreach (ArgumentModelItem argument, readItemList<ArgumentModelItem>())
+            function->addArgument(argument);
+
+        qint32 functionType;
+        bool isVirtual, isInline, isExplicit, isInvokable, isAbstract, isVariadics;
+        m_stream >> functionType
+                 >> isVirtual >> isInline >> isExplicit
+                 >> isInvokable >> isAbstract >> isVariadics;
+        function->setFunctionType(CodeModel::FunctionType(functionType));
+        function->setVirtual(isVirtual);
+        function->setInline(isInline);
+        function->setExplicit(isExplicit);
+        function->setInvokable(isInvokable);
+        function->setAbstract(isAbstract);
+        function->setVariadics(isVariadics);
+    }
+
+    if (ArgumentModelItem argument = model_dynamic_cast<ArgumentModelItem>(item)) {
+        argument->setType(readTypeInfo());
+
+        bool defaultValue;
+        QString defaultValueExpression;
+        m_stream >> defaultValue >> defaultValueExpression;
+        argument->setDefaultValue(defaultValue);
+        argument->setDefaultValueExpression(defaultValueExpression);
+    }
+
+    if (TypeAliasModelItem alias = model_dynamic_cast<TypeAliasModelItem>(item))
+        alias->setType(readTypeInfo());
+
+    if (EnumModelItem enumItem = model_dynamic_cast<EnumModelItem>(item)) {
+        qint32 accessPolicy;
+        bool isAnonymous;
+        m_stream >> accessPolicy >> isAnonymous;
+        enumItem->setAccessPolicy(CodeModel::AccessPolicy(accessPolicy));
+        enumItem->setAnonymous(isAnonymous);
+        foreach (EnumeratorModelItem enumerator, readItemList<EnumeratorModelItem>())
+            enumItem->addEnumerator(enumerator);
+    }
+
+    if (EnumeratorModelItem enumerator = model_dynamic_cast<EnumeratorModelItem>(item)) {
+        QString value;
+        m_stream >> value;
+        enumerator->setValue(value);
+    }
+
+    if (TemplateParameterModelItem parameter = model_dynamic_cast<TemplateParameterModelItem>(item)) {
+        parameter->setType(readTypeInfo());
+
+        bool defaultValue;
+        m_stream >> defaultValue;
+        parameter->setDefaultValue(defaultValue);
+    }
+
+    return item;
+}
+
+void CodeModelSnapshot::readScope(ScopeModelItem item)
+{
+    foreach (ClassModelItem klass, readItemList<ClassModelItem>())
+        item->addClass(klass);
+    foreach (EnumModelItem enumItem, readItemList<EnumModelItem>())
+        item->addEnum(enumItem);
+    foreach (TypeAliasModelItem alias, readItemList<TypeAliasModelItem>())
+        item->addTypeAlias(alias);
+    foreach (VariableModelItem variable, readItemList<VariableModelItem>())
+        item->addVariable(variable);
+    foreach (FunctionDefinitionModelItem definition, readItemList<FunctionDefinitionModelItem>())
+        item->addFunctionDefinition(definition);
+    foreach (FunctionModelItem function, readItemList<FunctionModelItem>())
+        item->addFunction(function);
+
+    QStringList enumsDeclarations;
+    m_stream >> enumsDeclarations;
+    foreach (QString enumsDeclaration, enumsDeclarations)
+        item->addEnumsDeclaration(enumsDeclaration);
+}
+
+TypeInfo CodeModelSnapshot::readTypeInfo()
+{
+    QStringList qualifiedName, arrayElements;
+    bool isConstant, isVolatile, isReference, isFunctionPointer;
+    qint32 indirections, argumentCount;
+    m_stream >> qualifiedName >> arrayElements
+             >> isConstant >> isVolatile >> isReference >> isFunctionPointer
+             >> indirections >> argumentCount;
+
+    TypeInfo type;
+    type.setQualifiedName(qualifiedName);
+    type.setArrayElements(arrayElements);
+    type.setConstant(isConstant);
+    type.setVolatile(isVolatile);
+    type.setReference(isReference);
+    type.setFunctionPointer(isFunctionPointer);
+    type.setIndirections(indirections);
+
+    for (int i = 0; i < argumentCount && m_stream.status() == QDataStream::Ok; ++i)
+        type.addArgument(readTypeInfo());
+
+    return type;
+}
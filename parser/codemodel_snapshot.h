@@ -0,0 +1,111 @@
+/*
+ * This file is part of the API Extractor project.
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef CODEMODEL_SNAPSHOT_H
+#define CODEMODEL_SNAPSHOT_H
+
+#include "codemodel.h"
+
+#include <QtCore/QDataStream>
+
+class QIODevice;
+
+/**
+ * Binary snapshot of a bound FileModelItem.
+ *
+ * A snapshot stores the whole item tree in a versioned QDataStream based
+ * format, together with the fingerprint of the preprocessed input it was
+ * built from. Loading it gives back an equivalent model without running
+ * the lexer, parser or binder; items shared between several scopes (e.g.
+ * template parameters or function definitions also listed as functions)
+ * stay shared.
+ */
+class CodeModelSnapshot
+{
+public:
+    /// Returns the fingerprint used to key snapshots of @p input.
+    static QByteArray fingerprint(const QByteArray &input);
+
+    /// @p partitions are the per file fingerprints of the input, see
+    /// CodeModelPartition.
+    static bool save(QIODevice *device, FileModelItem file, const QByteArray &fingerprint,
+                     const QHash<QString, QByteArray> &partitions = QHash<QString, QByteArray>());
+
+    /// Returns a null item if the snapshot is unreadable, was written by a
+    /// different format version or does not match @p fingerprint. An empty
+    /// @p fingerprint accepts any snapshot, whose per file fingerprints are
+    /// then stored in @p partitions to update it incrementally.
+    static FileModelItem load(QIODevice *device, CodeModel *model, const QByteArray &fingerprint,
+                              QHash<QString, QByteArray> *partitions = 0);
+
+private:
+    CodeModelSnapshot(QIODevice *device, CodeModel *model = 0);
+
+    void writeItem(CodeModelItem item);
+    void writeScope(ScopeModelItem item);
+    void writeTypeInfo(const TypeInfo &type);
+
+    template <class _List> void writeItemList(const _List &list)
+    {
+        m_stream << qint32(list.size());
+        for (typename _List::const_iterator it = list.begin(); it != list.end(); ++it)
+            writeItem(model_static_cast<CodeModelItem>(*it));
+    }
+
+    // QMultiHash::values() lists the items of a name latest first; they
+    // are written in the order they were added, so that adding them back
+    // one by one restores the original order of overloads.
+    template <class _Item> void writeItemMultiHash(const QMultiHash<QString, _Item> &hash)
+    {
+        QList<_Item> items;
+        foreach (const QString &name, hash.uniqueKeys()) {
+            QList<_Item> overloads = hash.values(name);
+            for (int i = overloads.size() - 1; i >= 0; --i)
+                items << overloads.at(i);
+        }
+        writeItemList(items);
+    }
+
+    CodeModelItem readItem();
+    CodeModelItem createItem(int kind);
+    void readScope(ScopeModelItem item);
+    TypeInfo readTypeInfo();
+
+    template <class _Item> QList<_Item> readItemList()
+    {
+        qint32 count;
+        m_stream >> count;
+
+        QList<_Item> list;
+        for (int i = 0; i < count && m_stream.status() == QDataStream::Ok; ++i)
+            list.append(model_static_cast<_Item>(readItem()));
+        return list;
+    }
+
+    QDataStream m_stream;
+    CodeModel *m_model;
+    QHash<const _CodeModelItem *, qint32> m_writtenItems;
+    ItemList m_readItems;
+};
+
+#endif // CODEMODEL_SNAPSHOT_H
@@ -26,7 +26,7 @@
 #ifndef DECLARATOR_COMPILER_H
 #define DECLARATOR_COMPILER_H
 
-#include "default_visitor.h"
+#include "static_visitor.h"
 #include "codemodel.h"
 
 #include <QtCore/QString>
@@ -35,8 +35,10 @@
 class TokenStream;
 class Binder;
 
-class DeclaratorCompiler: protected DefaultVisitor
+class DeclaratorCompiler: protected StaticVisitor<DeclaratorCompiler>
 {
+    friend class StaticVisitor<DeclaratorCompiler>;
+
 public:
     struct Parameter {
         TypeInfo type;
@@ -75,8 +77,8 @@ public:
     }
 
 protected:
-    virtual void visitPtrOperator(PtrOperatorAST *node);
-    virtual void visitParameterDeclaration(ParameterDeclarationAST *node);
+    void visitPtrOperator(PtrOperatorAST *node);
+    void visitParameterDeclaration(ParameterDeclarationAST *node);
 
 private:
     Binder *_M_binder;
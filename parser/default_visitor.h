@@ -109,6 +109,8 @@ protected:
     virtual void visitWinDeclSpec(WinDeclSpecAST *);
 
 private:
+    class Traversal;
+
     typedef void (Visitor::*visitor_fun_ptr)(AST *);
     static visitor_fun_ptr _S_table[];
 };
@@ -27,23 +27,41 @@
 #define FASTLIST_H
 
 #include "smallobject.h"
+#include <QtCore/qglobal.h>
 
+/**
+ * Singly linked, circular list of AST elements allocated from a pool.
+ *
+ * While a list is being built with snoc() its nodes are scattered in the
+ * pool and count(), at() and toFront() have to walk the ring. Once the
+ * parser is done with a list it calls finalize(), which relocates the
+ * nodes into one contiguous block; from then on those operations are O(1)
+ * and iterating through next walks the block in memory order. The ring
+ * links are kept intact, so code that walks next from toFront() works on
+ * both representations.
+ */
 template <typename Tp>
 struct ListNode {
     Tp element;
     int index;
+    /// Number of elements in the contiguous block, or 0 if not finalized.
+    mutable int size;
     mutable const ListNode<Tp> *next;
 
     static ListNode *create(const Tp &element, pool *p) {
         ListNode<Tp> *node = new(p->allocate(sizeof(ListNode), strideof(ListNode))) ListNode();
         node->element = element;
         node->index = 0;
+        node->size = 0;
         node->next = node;
 
         return node;
     }
 
     static ListNode *create(const ListNode *n1, const Tp &element, pool *p) {
+        if (n1->isFinalized())
+            n1->unfinalize();
+
         ListNode<Tp> *n2 = ListNode::create(element, p);
 
         n2->index = n1->index + 1;
@@ -55,7 +73,16 @@ struct ListNode {
 
     inline ListNode<Tp>() { }
 
+    inline bool isFinalized() const {
+        return size > 0;
+    }
+
     inline const ListNode<Tp> *at(int index) const {
+        if (isFinalized()) {
+            Q_ASSERT(index >= 0 && index < size);
+            return this - this->index + index;
+        }
+
         const ListNode<Tp> *node = this;
         while (index != node->index)
             node = node->next;
@@ -68,20 +95,39 @@ struct ListNode {
     }
 
     inline int count() const {
+        if (isFinalized())
+            return size;
+
         return 1 + toBack()->index;
     }
 
     inline const ListNode<Tp> *toFront() const {
+        if (isFinalized())
+            return this - index;
+
         return toBack()->next;
     }
 
     inline const ListNode<Tp> *toBack() const {
+        if (isFinalized())
+            return this - index + size - 1;
+
         const ListNode<Tp> *node = this;
         while (node->hasNext())
             node = node->next;
 
         return node;
     }
+
+private:
+    // Appending to a finalized list turns it back into a plain ring, the
+    // block stays linked so only the size markers have to be dropped.
+    inline void unfinalize() const {
+        const ListNode<Tp> *node = this - index;
+        const ListNode<Tp> *end = node + size;
+        for (; node != end; ++node)
+            node->size = 0;
+    }
 };
 
 template <class Tp>
@@ -94,6 +140,34 @@ inline const ListNode<Tp> *snoc(const ListNode<Tp> *list,
     return ListNode<Tp>::create(list->toBack(), element, p);
 }
 
+/**
+ * Relocates a completed list into a contiguous block allocated from @p p
+ * and returns its last node, like snoc() does. Lists that are empty or
+ * already finalized are returned unchanged.
+ */
+template <class Tp>
+inline const ListNode<Tp> *finalize(const ListNode<Tp> *list, pool *p)
+{
+    if (!list || list->isFinalized())
+        return list;
+
+    const ListNode<Tp> *it = list->toFront();
+    const int count = list->toBack()->index + 1;
+
+    ListNode<Tp> *block = reinterpret_cast<ListNode<Tp> *>(
+        p->allocate(count * sizeof(ListNode<Tp>), strideof(ListNode<Tp>)));
+
+    for (int i = 0; i < count; ++i, it = it->next) {
+        ListNode<Tp> *node = new(block + i) ListNode<Tp>();
+        node->element = it->element;
+        node->index = i;
+        node->size = count;
+        node->next = block + (i + 1) % count;
+    }
+
+    return block + count - 1;
+}
+
 #endif // FASTLIST_H
 
 // kate: space-indent on; indent-width 2; replace-tabs on;
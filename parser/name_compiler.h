@@ -26,14 +26,16 @@
 #ifndef NAME_COMPILER_H
 #define NAME_COMPILER_H
 
-#include "default_visitor.h"
+#include "static_visitor.h"
 #include <QtCore/QStringList>
 
 class TokenStream;
 class Binder;
 
-class NameCompiler: protected DefaultVisitor
+class NameCompiler: protected StaticVisitor<NameCompiler>
 {
+    friend class StaticVisitor<NameCompiler>;
+
 public:
     NameCompiler(Binder *binder);
 
@@ -52,8 +54,8 @@ public:
     }
 
 protected:
-    virtual void visitUnqualifiedName(UnqualifiedNameAST *node);
-    virtual void visitTemplateArgument(TemplateArgumentAST *node);
+    void visitUnqualifiedName(UnqualifiedNameAST *node);
+    void visitTemplateArgument(TemplateArgumentAST *node);
 
     QString internal_run(AST *node);
     QString decode_operator(std::size_t index) const;
@@ -363,6 +363,8 @@ bool Parser::parseName(NameAST *&node, bool acceptTemplateId)
     if (idx == token_stream.cursor())
         return false;
 
+    ast->qualified_names = finalize(ast->qualified_names, _M_pool);
+
     UPDATE_POS(ast, start, token_stream.cursor());
     node = ast;
 
@@ -392,6 +394,8 @@ bool Parser::parseTranslationUnit(TranslationUnitAST *&node)
         }
     }
 
+    ast->declarations = finalize(ast->declarations, _M_pool);
+
     UPDATE_POS(ast, start, token_stream.cursor());
     node = ast;
 
@@ -522,6 +526,8 @@ bool Parser::parseLinkageBody(LinkageBodyAST *&node)
         }
     }
 
+    ast->declarations = finalize(ast->declarations, _M_pool);
+
     if (token_stream.lookAhead() != '}')
         reportError(("} expected"));
     else
@@ -687,6 +693,7 @@ bool Parser::parseTemplateArgumentList(const ListNode<TemplateArgumentAST*> *&no
         node = snoc(node, templArg, _M_pool);
     }
 
+    node = finalize(node, _M_pool);
     return true;
 }
 
@@ -1272,6 +1279,8 @@ bool Parser::parseEnumSpecifier(TypeSpecifierAST *&node)
         }
     }
 
+    ast->enumerators = finalize(ast->enumerators, _M_pool);
+
     ADVANCE_NR('}', "}");
 
     UPDATE_POS(ast, start, token_stream.cursor());
@@ -1299,6 +1308,7 @@ bool Parser::parseTemplateParameterList(const ListNode<TemplateParameterAST*> *&
         }
     }
 
+    node = finalize(node, _M_pool);
     return true;
 }
 
@@ -1468,6 +1478,7 @@ bool Parser::parseInitDeclaratorList(const ListNode<InitDeclaratorAST*> *&node)
         node = snoc(node, decl, _M_pool);
     }
 
+    node = finalize(node, _M_pool);
     return true;
 }
 
@@ -1530,6 +1541,7 @@ bool Parser::parseParameterDeclarationList(const ListNode<ParameterDeclarationAS
         node = snoc(node, param, _M_pool);
     }
 
+    node = finalize(node, _M_pool);
     return true;
 }
 
@@ -1709,6 +1721,8 @@ bool Parser::parseClassSpecifier(TypeSpecifierAST *&node)
             ast->member_specs = snoc(ast->member_specs, memSpec, _M_pool);
     }
 
+    ast->member_specs = finalize(ast->member_specs, _M_pool);
+
     ADVANCE_NR('}', "}");
 
     UPDATE_POS(ast, start, token_stream.cursor());
@@ -1960,6 +1974,8 @@ bool Parser::parseBaseClause(BaseClauseAST *&node)
         ast->base_specifiers = snoc(ast->base_specifiers, baseSpec, _M_pool);
     }
 
+    ast->base_specifiers = finalize(ast->base_specifiers, _M_pool);
+
     UPDATE_POS(ast, start, token_stream.cursor());
     node = ast;
 
@@ -2012,6 +2028,7 @@ bool Parser::parseMemInitializerList(const ListNode<MemInitializerAST*> *&node)
         node = snoc(node, init, _M_pool);
     }
 
+    node = finalize(node, _M_pool);
     return true;
 }
 
@@ -2058,6 +2075,7 @@ bool Parser::parseTypeIdList(const ListNode<TypeIdAST*> *&node)
         }
     }
 
+    node = finalize(node, _M_pool);
     return true;
 }
 
@@ -2550,6 +2568,8 @@ bool Parser::parseCompoundStatement(StatementAST *&node)
         }
     }
 
+    ast->statements = finalize(ast->statements, _M_pool);
+
     ADVANCE_NR('}', "}");
 
     UPDATE_POS(ast, start, token_stream.cursor());
@@ -75,25 +75,25 @@ public:
   pointer address(reference __val) { return &__val; }
   const_pointer address(const_reference __val) const { return &__val; }
 
-  /**Allocates @p __n elements continuosly in the pool. Warning! no
-  check is done to check if the size of those @p __n elements
-  fit into the block. You should assure you do not allocate more
-  than the size of a block.*/
+  /**Allocates @p __n elements continuosly in the pool. Requests larger
+  than a block get a block of their own, sized to fit them.*/
   pointer allocate(size_type __n, const void* = 0) {
     const size_type bytes = __n * sizeof(_Tp);
 
     if (_M_current_block == 0
 	|| _S_block_size < _M_current_index + bytes)
       {
+	const size_type block_size = bytes > _S_block_size ? bytes : _S_block_size;
+
 	++_M_block_index;
 
 	_M_storage = reinterpret_cast<char**>
 	  (::realloc(_M_storage, sizeof(char*) * (1 + _M_block_index)));
 
 	_M_current_block = _M_storage[_M_block_index] = reinterpret_cast<char*>
-	  (new char[_S_block_size]);
+	  (new char[block_size]);
 
-	::memset(_M_current_block, 0, _S_block_size);
+	::memset(_M_current_block, 0, block_size);
 	_M_current_index = 0;
       }
 
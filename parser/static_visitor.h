@@ -0,0 +1,677 @@
+/*
+ * This file is part of the API Extractor project.
+ *
+ * Copyright (C) 2009 Nokia Corporation and/or its subsidiary(-ies).
+ * Copyright (C) 2002-2005 Roberto Raggi <roberto@kdevelop.org>
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+
+#ifndef STATIC_VISITOR_H
+#define STATIC_VISITOR_H
+
+#include "visitor.h"
+
+/**
+ * Statically dispatched counterpart of DefaultVisitor.
+ *
+ * Derived classes pass themselves as @p Derived and hide the visitXxx
+ * members they are interested in; visit() switches on the node kind and
+ * calls the most derived visitXxx directly, so there is no table lookup
+ * or virtual call per node and simple visitors can be fully inlined.
+ * The default visitXxx members are the traversal DefaultVisitor runs
+ * as well. They visit children through the most derived visit(), so a
+ * derived class may hide visit() to see every child node before it is
+ * dispatched.
+ *
+ * Derived classes that keep their visitXxx members non-public must make
+ * StaticVisitor<Derived> a friend.
+ */
+template <class Derived>
+class StaticVisitor
+{
+public:
+    void visit(AST *node);
+
+protected:
+    inline Derived *derived() {
+        return static_cast<Derived *>(this);
+    }
+
+    template <class _Tp>
+    void visitList(const ListNode<_Tp> *nodes) {
+        if (!nodes)
+            return;
+
+        const ListNode<_Tp> *it = nodes->toFront(), *end = it;
+        do {
+            derived()->visit(it->element);
+            it = it->next;
+        } while (it != end);
+    }
+
+    void visitAccessSpecifier(AccessSpecifierAST *) {}
+
+    void visitAsmDefinition(AsmDefinitionAST *) {}
+
+    void visitBaseClause(BaseClauseAST *node) {
+        visitList(node->base_specifiers);
+    }
+
+    void visitBaseSpecifier(BaseSpecifierAST *node) {
+        derived()->visit(node->name);
+    }
+
+    void visitBinaryExpression(BinaryExpressionAST *node) {
+        derived()->visit(node->left_expression);
+        derived()->visit(node->right_expression);
+    }
+
+    void visitCastExpression(CastExpressionAST *node) {
+        derived()->visit(node->type_id);
+        derived()->visit(node->expression);
+    }
+
+    void visitClassMemberAccess(ClassMemberAccessAST *node) {
+        derived()->visit(node->name);
+    }
+
+    void visitClassSpecifier(ClassSpecifierAST *node) {
+        derived()->visit(node->win_decl_specifiers);
+        derived()->visit(node->name);
+        derived()->visit(node->base_clause);
+        visitList(node->member_specs);
+    }
+
+    void visitCompoundStatement(CompoundStatementAST *node) {
+        visitList(node->statements);
+    }
+
+    void visitCondition(ConditionAST *node) {
+        derived()->visit(node->type_specifier);
+        derived()->visit(node->declarator);
+        derived()->visit(node->expression);
+    }
+
+    void visitConditionalExpression(ConditionalExpressionAST *node) {
+        derived()->visit(node->condition);
+        derived()->visit(node->left_expression);
+        derived()->visit(node->right_expression);
+    }
+
+    void visitCppCastExpression(CppCastExpressionAST *node) {
+        derived()->visit(node->type_id);
+        derived()->visit(node->expression);
+        visitList(node->sub_expressions);
+    }
+
+    void visitCtorInitializer(CtorInitializerAST *node) {
+        visitList(node->member_initializers);
+    }
+
+    void visitDeclarationStatement(DeclarationStatementAST *node) {
+        derived()->visit(node->declaration);
+    }
+
+    void visitDeclarator(DeclaratorAST *node) {
+        derived()->visit(node->sub_declarator);
+        visitList(node->ptr_ops);
+        derived()->visit(node->id);
+        derived()->visit(node->bit_expression);
+        visitList(node->array_dimensions);
+        derived()->visit(node->parameter_declaration_clause);
+        derived()->visit(node->exception_spec);
+    }
+
+    void visitDeleteExpression(DeleteExpressionAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitDoStatement(DoStatementAST *node) {
+        derived()->visit(node->statement);
+        derived()->visit(node->expression);
+    }
+
+    void visitElaboratedTypeSpecifier(ElaboratedTypeSpecifierAST *node) {
+        derived()->visit(node->name);
+    }
+
+    void visitEnumSpecifier(EnumSpecifierAST *node) {
+        derived()->visit(node->name);
+        visitList(node->enumerators);
+    }
+
+    void visitEnumerator(EnumeratorAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitExceptionSpecification(ExceptionSpecificationAST *node) {
+        visitList(node->type_ids);
+    }
+
+    void visitExpressionOrDeclarationStatement(ExpressionOrDeclarationStatementAST *node) {
+        derived()->visit(node->expression);
+        derived()->visit(node->declaration);
+    }
+
+    void visitExpressionStatement(ExpressionStatementAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitForStatement(ForStatementAST *node) {
+        derived()->visit(node->init_statement);
+        derived()->visit(node->condition);
+        derived()->visit(node->expression);
+        derived()->visit(node->statement);
+    }
+
+    void visitFunctionCall(FunctionCallAST *node) {
+        derived()->visit(node->arguments);
+    }
+
+    void visitFunctionDefinition(FunctionDefinitionAST *node) {
+        derived()->visit(node->type_specifier);
+        derived()->visit(node->init_declarator);
+        derived()->visit(node->function_body);
+        derived()->visit(node->win_decl_specifiers);
+    }
+
+    void visitIfStatement(IfStatementAST *node) {
+        derived()->visit(node->condition);
+        derived()->visit(node->statement);
+        derived()->visit(node->else_statement);
+    }
+
+    void visitIncrDecrExpression(IncrDecrExpressionAST *) {}
+
+    void visitInitDeclarator(InitDeclaratorAST *node) {
+        derived()->visit(node->declarator);
+        derived()->visit(node->initializer);
+    }
+
+    void visitInitializer(InitializerAST *node) {
+        derived()->visit(node->initializer_clause);
+        derived()->visit(node->expression);
+    }
+
+    void visitInitializerClause(InitializerClauseAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitLabeledStatement(LabeledStatementAST *) {}
+
+    void visitLinkageBody(LinkageBodyAST *node) {
+        visitList(node->declarations);
+    }
+
+    void visitLinkageSpecification(LinkageSpecificationAST *node) {
+        derived()->visit(node->linkage_body);
+        derived()->visit(node->declaration);
+    }
+
+    void visitMemInitializer(MemInitializerAST *node) {
+        derived()->visit(node->initializer_id);
+        derived()->visit(node->expression);
+    }
+
+    void visitName(NameAST *node) {
+        visitList(node->qualified_names);
+        derived()->visit(node->unqualified_name);
+    }
+
+    void visitNamespace(NamespaceAST *node) {
+        derived()->visit(node->linkage_body);
+    }
+
+    void visitNamespaceAliasDefinition(NamespaceAliasDefinitionAST *node) {
+        derived()->visit(node->alias_name);
+    }
+
+    void visitNewDeclarator(NewDeclaratorAST *node) {
+        derived()->visit(node->ptr_op);
+        derived()->visit(node->sub_declarator);
+        visitList(node->expressions);
+    }
+
+    void visitNewExpression(NewExpressionAST *node) {
+        derived()->visit(node->expression);
+        derived()->visit(node->type_id);
+        derived()->visit(node->new_type_id);
+        derived()->visit(node->new_initializer);
+    }
+
+    void visitNewInitializer(NewInitializerAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitNewTypeId(NewTypeIdAST *node) {
+        derived()->visit(node->type_specifier);
+        derived()->visit(node->new_initializer);
+        derived()->visit(node->new_declarator);
+    }
+
+    void visitOperator(OperatorAST *) {}
+
+    void visitOperatorFunctionId(OperatorFunctionIdAST *node) {
+        derived()->visit(node->op);
+        derived()->visit(node->type_specifier);
+        visitList(node->ptr_ops);
+    }
+
+    void visitParameterDeclaration(ParameterDeclarationAST *node) {
+        derived()->visit(node->type_specifier);
+        derived()->visit(node->declarator);
+        derived()->visit(node->expression);
+    }
+
+    void visitParameterDeclarationClause(ParameterDeclarationClauseAST *node) {
+        visitList(node->parameter_declarations);
+    }
+
+    void visitPostfixExpression(PostfixExpressionAST *node) {
+        derived()->visit(node->type_specifier);
+        derived()->visit(node->expression);
+        visitList(node->sub_expressions);
+    }
+
+    void visitPrimaryExpression(PrimaryExpressionAST *node) {
+        derived()->visit(node->literal);
+        derived()->visit(node->expression_statement);
+        derived()->visit(node->sub_expression);
+        derived()->visit(node->name);
+    }
+
+    void visitPtrOperator(PtrOperatorAST *node) {
+        derived()->visit(node->mem_ptr);
+    }
+
+    void visitPtrToMember(PtrToMemberAST *) {}
+
+    void visitReturnStatement(ReturnStatementAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitSimpleDeclaration(SimpleDeclarationAST *node) {
+        derived()->visit(node->type_specifier);
+        visitList(node->init_declarators);
+        derived()->visit(node->win_decl_specifiers);
+    }
+
+    void visitSimpleTypeSpecifier(SimpleTypeSpecifierAST *node) {
+        derived()->visit(node->name);
+        derived()->visit(node->type_id);
+        derived()->visit(node->expression);
+    }
+
+    void visitSizeofExpression(SizeofExpressionAST *node) {
+        derived()->visit(node->type_id);
+        derived()->visit(node->expression);
+    }
+
+    void visitStringLiteral(StringLiteralAST *) {}
+
+    void visitSubscriptExpression(SubscriptExpressionAST *node) {
+        derived()->visit(node->subscript);
+    }
+
+    void visitSwitchStatement(SwitchStatementAST *node) {
+        derived()->visit(node->condition);
+        derived()->visit(node->statement);
+    }
+
+    void visitTemplateArgument(TemplateArgumentAST *node) {
+        derived()->visit(node->type_id);
+        derived()->visit(node->expression);
+    }
+
+    void visitTemplateDeclaration(TemplateDeclarationAST *node) {
+        visitList(node->template_parameters);
+        derived()->visit(node->declaration);
+    }
+
+    void visitTemplateParameter(TemplateParameterAST *node) {
+        derived()->visit(node->type_parameter);
+        derived()->visit(node->parameter_declaration);
+    }
+
+    void visitThrowExpression(ThrowExpressionAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitTranslationUnit(TranslationUnitAST *node) {
+        visitList(node->declarations);
+    }
+
+    void visitTryBlockStatement(TryBlockStatementAST *) {}
+
+    void visitTypeId(TypeIdAST *node) {
+        derived()->visit(node->type_specifier);
+        derived()->visit(node->declarator);
+    }
+
+    void visitTypeIdentification(TypeIdentificationAST *node) {
+        derived()->visit(node->name);
+        derived()->visit(node->expression);
+    }
+
+    void visitTypeParameter(TypeParameterAST *node) {
+        derived()->visit(node->name);
+        derived()->visit(node->type_id);
+        visitList(node->template_parameters);
+        derived()->visit(node->template_name);
+    }
+
+    void visitTypedef(TypedefAST *node) {
+        derived()->visit(node->type_specifier);
+        visitList(node->init_declarators);
+    }
+
+    void visitUnaryExpression(UnaryExpressionAST *node) {
+        derived()->visit(node->expression);
+    }
+
+    void visitUnqualifiedName(UnqualifiedNameAST *node) {
+        derived()->visit(node->operator_id);
+        visitList(node->template_arguments);
+    }
+
+    void visitUsing(UsingAST *node) {
+        derived()->visit(node->name);
+    }
+
+    void visitUsingDirective(UsingDirectiveAST *node) {
+        derived()->visit(node->name);
+    }
+
+    void visitWhileStatement(WhileStatementAST *node) {
+        derived()->visit(node->condition);
+        derived()->visit(node->statement);
+    }
+
+    void visitWinDeclSpec(WinDeclSpecAST *) {}
+
+    void visitQProperty(QPropertyAST *) {}
+
+    void visitForwardDeclarationSpecifier(ForwardDeclarationSpecifierAST *) {}
+
+    void visitQEnums(QEnumsAST *) {}
+
+};
+
+template <class Derived>
+void StaticVisitor<Derived>::visit(AST *node)
+{
+    if (!node)
+        return;
+
+    Derived *d = derived();
+
+    switch (node->kind) {
+    case AST::Kind_AccessSpecifier:
+        d->visitAccessSpecifier(static_cast<AccessSpecifierAST *>(node));
+        break;
+    case AST::Kind_AsmDefinition:
+        d->visitAsmDefinition(static_cast<AsmDefinitionAST *>(node));
+        break;
+    case AST::Kind_BaseClause:
+        d->visitBaseClause(static_cast<BaseClauseAST *>(node));
+        break;
+    case AST::Kind_BaseSpecifier:
+        d->visitBaseSpecifier(static_cast<BaseSpecifierAST *>(node));
+        break;
+    case AST::Kind_BinaryExpression:
+        d->visitBinaryExpression(static_cast<BinaryExpressionAST *>(node));
+        break;
+    case AST::Kind_CastExpression:
+        d->visitCastExpression(static_cast<CastExpressionAST *>(node));
+        break;
+    case AST::Kind_ClassMemberAccess:
+        d->visitClassMemberAccess(static_cast<ClassMemberAccessAST *>(node));
+        break;
+    case AST::Kind_ClassSpecifier:
+        d->visitClassSpecifier(static_cast<ClassSpecifierAST *>(node));
+        break;
+    case AST::Kind_CompoundStatement:
+        d->visitCompoundStatement(static_cast<CompoundStatementAST *>(node));
+        break;
+    case AST::Kind_Condition:
+        d->visitCondition(static_cast<ConditionAST *>(node));
+        break;
+    case AST::Kind_ConditionalExpression:
+        d->visitConditionalExpression(static_cast<ConditionalExpressionAST *>(node));
+        break;
+    case AST::Kind_CppCastExpression:
+        d->visitCppCastExpression(static_cast<CppCastExpressionAST *>(node));
+        break;
+    case AST::Kind_CtorInitializer:
+        d->visitCtorInitializer(static_cast<CtorInitializerAST *>(node));
+        break;
+    case AST::Kind_DeclarationStatement:
+        d->visitDeclarationStatement(static_cast<DeclarationStatementAST *>(node));
+        break;
+    case AST::Kind_Declarator:
+        d->visitDeclarator(static_cast<DeclaratorAST *>(node));
+        break;
+    case AST::Kind_DeleteExpression:
+        d->visitDeleteExpression(static_cast<DeleteExpressionAST *>(node));
+        break;
+    case AST::Kind_DoStatement:
+        d->visitDoStatement(static_cast<DoStatementAST *>(node));
+        break;
+    case AST::Kind_ElaboratedTypeSpecifier:
+        d->visitElaboratedTypeSpecifier(static_cast<ElaboratedTypeSpecifierAST *>(node));
+        break;
+    case AST::Kind_EnumSpecifier:
+        d->visitEnumSpecifier(static_cast<EnumSpecifierAST *>(node));
+        break;
+    case AST::Kind_Enumerator:
+        d->visitEnumerator(static_cast<EnumeratorAST *>(node));
+        break;
+    case AST::Kind_ExceptionSpecification:
+        d->visitExceptionSpecification(static_cast<ExceptionSpecificationAST *>(node));
+        break;
+    case AST::Kind_ExpressionOrDeclarationStatement:
+        d->visitExpressionOrDeclarationStatement(static_cast<ExpressionOrDeclarationStatementAST *>(node));
+        break;
+    case AST::Kind_ExpressionStatement:
+        d->visitExpressionStatement(static_cast<ExpressionStatementAST *>(node));
+        break;
+    case AST::Kind_ForStatement:
+        d->visitForStatement(static_cast<ForStatementAST *>(node));
+        break;
+    case AST::Kind_FunctionCall:
+        d->visitFunctionCall(static_cast<FunctionCallAST *>(node));
+        break;
+    case AST::Kind_FunctionDefinition:
+        d->visitFunctionDefinition(static_cast<FunctionDefinitionAST *>(node));
+        break;
+    case AST::Kind_IfStatement:
+        d->visitIfStatement(static_cast<IfStatementAST *>(node));
+        break;
+    case AST::Kind_IncrDecrExpression:
+        d->visitIncrDecrExpression(static_cast<IncrDecrExpressionAST *>(node));
+        break;
+    case AST::Kind_InitDeclarator:
+        d->visitInitDeclarator(static_cast<InitDeclaratorAST *>(node));
+        break;
+    case AST::Kind_Initializer:
+        d->visitInitializer(static_cast<InitializerAST *>(node));
+        break;
+    case AST::Kind_InitializerClause:
+        d->visitInitializerClause(static_cast<InitializerClauseAST *>(node));
+        break;
+    case AST::Kind_LabeledStatement:
+        d->visitLabeledStatement(static_cast<LabeledStatementAST *>(node));
+        break;
+    case AST::Kind_LinkageBody:
+        d->visitLinkageBody(static_cast<LinkageBodyAST *>(node));
+        break;
+    case AST::Kind_LinkageSpecification:
+        d->visitLinkageSpecification(static_cast<LinkageSpecificationAST *>(node));
+        break;
+    case AST::Kind_MemInitializer:
+        d->visitMemInitializer(static_cast<MemInitializerAST *>(node));
+        break;
+    case AST::Kind_Name:
+        d->visitName(static_cast<NameAST *>(node));
+        break;
+    case AST::Kind_Namespace:
+        d->visitNamespace(static_cast<NamespaceAST *>(node));
+        break;
+    case AST::Kind_NamespaceAliasDefinition:
+        d->visitNamespaceAliasDefinition(static_cast<NamespaceAliasDefinitionAST *>(node));
+        break;
+    case AST::Kind_NewDeclarator:
+        d->visitNewDeclarator(static_cast<NewDeclaratorAST *>(node));
+        break;
+    case AST::Kind_NewExpression:
+        d->visitNewExpression(static_cast<NewExpressionAST *>(node));
+        break;
+    case AST::Kind_NewInitializer:
+        d->visitNewInitializer(static_cast<NewInitializerAST *>(node));
+        break;
+    case AST::Kind_NewTypeId:
+        d->visitNewTypeId(static_cast<NewTypeIdAST *>(node));
+        break;
+    case AST::Kind_Operator:
+        d->visitOperator(static_cast<OperatorAST *>(node));
+        break;
+    case AST::Kind_OperatorFunctionId:
+        d->visitOperatorFunctionId(static_cast<OperatorFunctionIdAST *>(node));
+        break;
+    case AST::Kind_ParameterDeclaration:
+        d->visitParameterDeclaration(static_cast<ParameterDeclarationAST *>(node));
+        break;
+    case AST::Kind_ParameterDeclarationClause:
+        d->visitParameterDeclarationClause(static_cast<ParameterDeclarationClauseAST *>(node));
+        break;
+    case AST::Kind_PostfixExpression:
+        d->visitPostfixExpression(static_cast<PostfixExpressionAST *>(node));
+        break;
+    case AST::Kind_PrimaryExpression:
+        d->visitPrimaryExpression(static_cast<PrimaryExpressionAST *>(node));
+        break;
+    case AST::Kind_PtrOperator:
+        d->visitPtrOperator(static_cast<PtrOperatorAST *>(node));
+        break;
+    case AST::Kind_PtrToMember:
+        d->visitPtrToMember(static_cast<PtrToMemberAST *>(node));
+        break;
+    case AST::Kind_ReturnStatement:
+        d->visitReturnStatement(static_cast<ReturnStatementAST *>(node));
+        break;
+    case AST::Kind_SimpleDeclaration:
+        d->visitSimpleDeclaration(static_cast<SimpleDeclarationAST *>(node));
+        break;
+    case AST::Kind_SimpleTypeSpecifier:
+        d->visitSimpleTypeSpecifier(static_cast<SimpleTypeSpecifierAST *>(node));
+        break;
+    case AST::Kind_SizeofExpression:
+        d->visitSizeofExpression(static_cast<SizeofExpressionAST *>(node));
+        break;
+    case AST::Kind_StringLiteral:
+        d->visitStringLiteral(static_cast<StringLiteralAST *>(node));
+        break;
+    case AST::Kind_SubscriptExpression:
+        d->visitSubscriptExpression(static_cast<SubscriptExpressionAST *>(node));
+        break;
+    case AST::Kind_SwitchStatement:
+        d->visitSwitchStatement(static_cast<SwitchStatementAST *>(node));
+        break;
+    case AST::Kind_TemplateArgument:
+        d->visitTemplateArgument(static_cast<TemplateArgumentAST *>(node));
+        break;
+    case AST::Kind_TemplateDeclaration:
+        d->visitTemplateDeclaration(static_cast<TemplateDeclarationAST *>(node));
+        break;
+    case AST::Kind_TemplateParameter:
+        d->visitTemplateParameter(static_cast<TemplateParameterAST *>(node));
+        break;
+    case AST::Kind_ThrowExpression:
+        d->visitThrowExpression(static_cast<ThrowExpressionAST *>(node));
+        break;
+    case AST::Kind_TranslationUnit:
+        d->visitTranslationUnit(static_cast<TranslationUnitAST *>(node));
+        break;
+    case AST::Kind_TryBlockStatement:
+        d->visitTryBlockStatement(static_cast<TryBlockStatementAST *>(node));
+        break;
+    case AST::Kind_TypeId:
+        d->visitTypeId(static_cast<TypeIdAST *>(node));
+        break;
+    case AST::Kind_TypeIdentification:
+        d->visitTypeIdentification(static_cast<TypeIdentificationAST *>(node));
+        break;
+    case AST::Kind_TypeParameter:
+        d->visitTypeParameter(static_cast<TypeParameterAST *>(node));
+        break;
+    case AST::Kind_Typedef:
+        d->visitTypedef(static_cast<TypedefAST *>(node));
+        break;
+    case AST::Kind_UnaryExpression:
+        d->visitUnaryExpression(static_cast<UnaryExpressionAST *>(node));
+        break;
+    case AST::Kind_UnqualifiedName:
+        d->visitUnqualifiedName(static_cast<UnqualifiedNameAST *>(node));
+        break;
+    case AST::Kind_Using:
+        d->visitUsing(static_cast<UsingAST *>(node));
+        break;
+    case AST::Kind_UsingDirective:
+        d->visitUsingDirective(static_cast<UsingDirectiveAST *>(node));
+        break;
+    case AST::Kind_WhileStatement:
+        d->visitWhileStatement(static_cast<WhileStatementAST *>(node));
+        break;
+    case AST::Kind_WinDeclSpec:
+        d->visitWinDeclSpec(static_cast<WinDeclSpecAST *>(node));
+        break;
+    case AST::Kind_QPropertyAST:
+        d->visitQProperty(static_cast<QPropertyAST *>(node));
+        break;
+    case AST::Kind_ForwardDeclarationSpecifier:
+        d->visitForwardDeclarationSpecifier(static_cast<ForwardDeclarationSpecifierAST *>(node));
+        break;
+    case AST::Kind_QEnumsAST:
+        d->visitQEnums(static_cast<QEnumsAST *>(node));
+        break;
+    default:
+        break;
+    }
+}
+
+template <class _Derived, class _Tp>
+void visitNodes(StaticVisitor<_Derived> *v, const ListNode<_Tp> *nodes)
+{
+    if (!nodes)
+        return;
+
+    const ListNode<_Tp>
+    *it = nodes->toFront(),
+          *end = it;
+
+    do {
+        v->visit(it->element);
+        it = it->next;
+    } while (it != end);
+}
+
+#endif // STATIC_VISITOR_H
+
+// kate: space-indent on; indent-width 2; replace-tabs on;
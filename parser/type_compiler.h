@@ -26,7 +26,7 @@
 #ifndef TYPE_COMPILER_H
 #define TYPE_COMPILER_H
 
-#include "default_visitor.h"
+#include "static_visitor.h"
 
 #include <QtCore/QString>
 #include <QtCore/QStringList>
@@ -35,8 +35,10 @@
 class TokenStream;
 class Binder;
 
-class TypeCompiler: protected DefaultVisitor
+class TypeCompiler: protected StaticVisitor<TypeCompiler>
 {
+    friend class StaticVisitor<TypeCompiler>;
+
 public:
     TypeCompiler(Binder *binder);
 
@@ -51,12 +53,12 @@ public:
     void run(TypeSpecifierAST *node);
 
 protected:
-    virtual void visitClassSpecifier(ClassSpecifierAST *node);
-    virtual void visitEnumSpecifier(EnumSpecifierAST *node);
-    virtual void visitElaboratedTypeSpecifier(ElaboratedTypeSpecifierAST *node);
-    virtual void visitSimpleTypeSpecifier(SimpleTypeSpecifierAST *node);
+    void visitClassSpecifier(ClassSpecifierAST *node);
+    void visitEnumSpecifier(EnumSpecifierAST *node);
+    void visitElaboratedTypeSpecifier(ElaboratedTypeSpecifierAST *node);
+    void visitSimpleTypeSpecifier(SimpleTypeSpecifierAST *node);
 
-    virtual void visitName(NameAST *node);
+    void visitName(NameAST *node);
 
 private:
     Binder *_M_binder;
@@ -24,6 +24,7 @@
 #include "reporthandler.h"
 #include "typesystem.h"
 #include "typedatabase.h"
+#include <QtCore/QMutex>
 #include <QtCore/QSet>
 #include <cstring>
 #include <cstdarg>
@@ -51,6 +52,8 @@ static QString m_progressBuffer;
 static int m_step_size = 0;
 static int m_step = -1;
 static int m_step_warning = 0;
+// warnings may come from the builder's worker threads
+static QMutex m_warningMutex;
 
 static void printProgress()
 {
@@ -119,6 +122,7 @@ void ReportHandler::warning(const QString &text)
 
 // Context is useless!
 //     QString warningText = QString("\r" COLOR_YELLOW "WARNING(%1)" COLOR_END " :: %2").arg(m_context).arg(text);
+    QMutexLocker locker(&m_warningMutex);
     TypeDatabase *db = TypeDatabase::instance();
     if (db && db->isSuppressedWarning(text)) {
         ++m_suppressedCount;
@@ -0,0 +1,206 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*
+*/
+
+#include "suppressedwarningmatcher.h"
+
+#include <QQueue>
+#include <QtAlgorithms>
+
+// Decisions for more distinct texts than this are dropped and relearned
+static const int MAX_CACHED_DECISIONS = 4096;
+
+SuppressedWarningMatcher::SuppressedWarningMatcher() : m_frozen(false), m_compiled(false)
+{
+}
+
+void SuppressedWarningMatcher::addPattern(const QString& pattern)
+{
+    Q_ASSERT_X(!m_frozen, "SuppressedWarningMatcher::addPattern", "the matcher is frozen");
+    QMutexLocker locker(&m_mutex);
+
+    QString escaped(QString(pattern).replace("\\*", "&place_holder_for_asterisk;"));
+    QStringList segs = escaped.split("*", QString::SkipEmptyParts);
+
+    m_patterns << pattern;
+    QVector<int> segments;
+    foreach (QString seg, segs) {
+        seg.replace("&place_holder_for_asterisk;", "*");
+        int index = m_segmentIndexes.value(seg, -1);
+        if (index < 0) {
+            index = m_segments.size();
+            m_segments << seg;
+            m_segmentIndexes.insert(seg, index);
+        }
+        segments << index;
+    }
+    m_patternSegments << segments;
+
+    m_compiled = false;
+    m_decisions.clear();
+}
+
+QStringList SuppressedWarningMatcher::patterns() const
+{
+    if (m_frozen)
+        return m_patterns;
+    QMutexLocker locker(&m_mutex);
+    return m_patterns;
+}
+
+void SuppressedWarningMatcher::freeze()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_compiled)
+        compile();
+    m_frozen = true;
+}
+
+bool SuppressedWarningMatcher::matches(const QString& text) const
+{
+    // Nothing is written once frozen; the decisions learned before stay
+    // valid since no pattern can be added anymore
+    if (m_frozen) {
+        QHash<QString, bool>::const_iterator it = m_decisions.constFind(text);
+        if (it != m_decisions.constEnd())
+            return it.value();
+        return search(text);
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, bool>::const_iterator it = m_decisions.constFind(text);
+    if (it != m_decisions.constEnd())
+        return it.value();
+
+    if (!m_compiled)
+        compile();
+
+    bool matched = search(text);
+    if (m_decisions.size() >= MAX_CACHED_DECISIONS)
+        m_decisions.clear();
+    m_decisions.insert(text, matched);
+    return matched;
+}
+
+int SuppressedWarningMatcher::Node::child(ushort c) const
+{
+    QVector<QPair<ushort, int> >::const_iterator it = qLowerBound(next.constBegin(), next.constEnd(), qMakePair(c, -1));
+    if (it != next.constEnd() && it->first == c)
+        return it->second;
+    return -1;
+}
+
+void SuppressedWarningMatcher::Node::addChild(ushort c, int node)
+{
+    QVector<QPair<ushort, int> >::iterator it = qLowerBound(next.begin(), next.end(), qMakePair(c, -1));
+    next.insert(it, qMakePair(c, node));
+}
+
+void SuppressedWarningMatcher::compile() const
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+
+    // The trie of all segments
+    for (int s = 0; s < m_segments.size(); ++s) {
+        const QString& seg = m_segments.at(s);
+        int node = 0;
+        for (int i = 0; i < seg.size(); ++i) {
+            ushort c = seg.at(i).unicode();
+            int next = m_nodes.at(node).child(c);
+            if (next < 0) {
+                next = m_nodes.size();
+                m_nodes.append(Node());
+                m_nodes[node].addChild(c, next);
+            }
+            node = next;
+        }
+        m_nodes[node].segments << s;
+    }
+
+    // Failure links, breadth first so the fail target is always complete
+    QQueue<int> queue;
+    for (int i = 0; i < m_nodes.at(0).next.size(); ++i)
+        queue.enqueue(m_nodes.at(0).next.at(i).second);
+    while (!queue.isEmpty()) {
+        int node = queue.dequeue();
+        for (int i = 0; i < m_nodes.at(node).next.size(); ++i) {
+            ushort c = m_nodes.at(node).next.at(i).first;
+            int child = m_nodes.at(node).next.at(i).second;
+            int fail = m_nodes.at(node).fail;
+            while (fail && m_nodes.at(fail).child(c) < 0)
+                fail = m_nodes.at(fail).fail;
+            fail = qMax(m_nodes.at(fail).child(c), 0);
+            if (fail == child)
+                fail = 0;
+            m_nodes[child].fail = fail;
+            m_nodes[child].segments += m_nodes.at(fail).segments;
+            queue.enqueue(child);
+        }
+    }
+
+    m_compiled = true;
+}
+
+bool SuppressedWarningMatcher::search(const QString& text) const
+{
+    if (m_segments.isEmpty())
+        return false;
+
+    // Start positions of every segment in the text, in increasing order
+    QVector<QVector<int> > starts(m_segments.size());
+    int node = 0;
+    for (int i = 0; i < text.size(); ++i) {
+        ushort c = text.at(i).unicode();
+        int next = m_nodes.at(node).child(c);
+        while (node && next < 0) {
+            node = m_nodes.at(node).fail;
+            next = m_nodes.at(node).child(c);
+        }
+        node = qMax(next, 0);
+        foreach (int s, m_nodes.at(node).segments)
+            starts[s] << i - m_segments.at(s).size() + 1;
+    }
+
+    // Like QString::indexOf(segment, from) chained from the start of the
+    // previous segment, taking the first occurrence every time.
+    for (int p = 0; p < m_patternSegments.size(); ++p) {
+        const QVector<int>& segments = m_patternSegments.at(p);
+        if (segments.isEmpty())
+            continue;
+        int pos = 0;
+        bool found = true;
+        foreach (int s, segments) {
+            const QVector<int>& positions = starts.at(s);
+            QVector<int>::const_iterator it = qLowerBound(positions.constBegin(), positions.constEnd(), pos);
+            if (it == positions.constEnd()) {
+                found = false;
+                break;
+            }
+            pos = *it;
+        }
+        if (found)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,96 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*
+*/
+
+#ifndef SUPPRESSEDWARNINGMATCHER_H
+#define SUPPRESSEDWARNINGMATCHER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+#include "apiextractormacros.h"
+
+/**
+*   Matches warning texts against the patterns of the suppress-warning
+*   type system entries. A pattern is a list of literal segments separated
+*   by '*' ("\*" being a literal asterisk), and matches any text containing
+*   its segments in that order.
+*
+*   All segments of all patterns are searched for in a single pass over the
+*   text with an Aho-Corasick automaton built when the first text is matched
+*   after patterns were added; the decisions for recent texts are cached.
+*   matches() may be called from several threads. Once freeze() was called
+*   no pattern may be added and matches() no longer locks nor caches.
+*/
+class APIEXTRACTOR_API SuppressedWarningMatcher
+{
+public:
+    SuppressedWarningMatcher();
+
+    void addPattern(const QString& pattern);
+    QStringList patterns() const;
+
+    bool matches(const QString& text) const;
+
+    void freeze();
+    bool isFrozen() const
+    {
+        return m_frozen;
+    }
+
+private:
+    struct Node
+    {
+        Node() : fail(0) {}
+        // the node reached by \p c, or -1
+        int child(ushort c) const;
+        void addChild(ushort c, int node);
+        // (character, node) pairs sorted by character; most nodes have one
+        QVector<QPair<ushort, int> > next;
+        int fail;
+        // segments ending at this node, including those of its fail chain
+        QVector<int> segments;
+    };
+
+    void compile() const;
+    bool search(const QString& text) const;
+
+    QStringList m_patterns;
+    // per pattern, the indexes in m_segments of its segments
+    QVector<QVector<int> > m_patternSegments;
+    QStringList m_segments;
+    QHash<QString, int> m_segmentIndexes;
+
+    mutable QMutex m_mutex;
+    bool m_frozen;
+    mutable bool m_compiled;
+    mutable QVector<Node> m_nodes;
+    mutable QHash<QString, bool> m_decisions;
+
+    // disable copy
+    SuppressedWarningMatcher(const SuppressedWarningMatcher&);
+    SuppressedWarningMatcher& operator=(const SuppressedWarningMatcher&);
+};
+
+#endif
@@ -441,6 +441,86 @@ void TestAbstractMetaClass::testIsPolymorphic()
     QVERIFY(!a->isPolymorphic());
 }
 
+void TestAbstractMetaClass::testBaseClassWithAmbiguousName()
+{
+    const char* cppCode ="\
+    namespace A { class C {}; }\
+    namespace B { class C {}; }\
+    class D : public B::C {};\
+    ";
+    const char* xmlCode = "\
+    <typesystem package=\"Foo\"> \
+        <namespace-type name=\"A\"/> \
+        <namespace-type name=\"B\"/> \
+        <value-type name=\"A::C\"/> \
+        <value-type name=\"B::C\"/> \
+        <value-type name=\"D\"/> \
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode);
+    AbstractMetaClassList classes = t.builder()->classes();
+    QCOMPARE(classes.count(), 5);
+
+    AbstractMetaClass* d = classes.findClass("D");
+    QVERIFY(d);
+    QVERIFY(d->baseClass());
+    QCOMPARE(d->baseClass()->qualifiedCppName(), QString("B::C"));
+    QCOMPARE(d->baseClass(), classes.findClass("B::C"));
+}
+
+void TestAbstractMetaClass::testFrozenFunctionQueries()
+{
+    const char* cppCode ="\
+    class A {\
+    public:\
+        A();\
+        virtual ~A();\
+        virtual void virtualMethod();\
+        virtual void pureVirtual() = 0;\
+        static void staticMethod();\
+        void method();\
+        A& operator+=(int);\
+    protected:\
+        void protectedMethod();\
+    private:\
+        void privateMethod();\
+    };\
+    ";
+    const char* xmlCode = "\
+    <typesystem package=\"Foo\"> \
+        <primitive-type name='int'/> \
+        <object-type name='A'/> \
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode);
+    AbstractMetaClass* classA = t.builder()->classes().findClass("A");
+    QVERIFY(classA);
+
+    QList<uint> queries;
+    queries << AbstractMetaClass::Constructors
+            << (AbstractMetaClass::VirtualFunctions | AbstractMetaClass::NotRemovedFromTargetLang)
+            << (AbstractMetaClass::StaticFunctions | AbstractMetaClass::Visible)
+            << (AbstractMetaClass::NormalFunctions | AbstractMetaClass::WasProtected)
+            << AbstractMetaClass::Invisible
+            << AbstractMetaClass::AbstractFunctions
+            << AbstractMetaClass::OperatorOverloads
+            << (AbstractMetaClass::NonStaticFunctions | AbstractMetaClass::FinalInCppFunctions)
+            << 0;
+
+    // build() leaves the classes frozen; setting the functions again
+    // makes queryFunctions() evaluate every predicate as before
+    QList<AbstractMetaFunctionList> frozenResults;
+    foreach (uint query, queries)
+        frozenResults << classA->queryFunctions(query);
+    classA->setFunctions(classA->functions());
+    for (int i = 0; i < queries.size(); ++i)
+        QCOMPARE(classA->queryFunctions(queries[i]), frozenResults[i]);
+
+    QCOMPARE(classA->queryFunctions(AbstractMetaClass::AbstractFunctions).size(), 1);
+
+    classA->freezeFunctionQueries();
+    for (int i = 0; i < queries.size(); ++i)
+        QCOMPARE(classA->queryFunctions(queries[i]), frozenResults[i]);
+}
+
 QTEST_APPLESS_MAIN(TestAbstractMetaClass)
 
 #include "testabstractmetaclass.moc"
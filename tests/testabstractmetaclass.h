@@ -43,6 +43,8 @@ private slots:
     void testAbstractClassDefaultConstructors();
     void testObjectTypesMustNotHaveCopyConstructors();
     void testIsPolymorphic();
+    void testBaseClassWithAmbiguousName();
+    void testFrozenFunctionQueries();
 };
 
 #endif // TESTABSTRACTMETACLASS_H
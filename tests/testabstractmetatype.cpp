@@ -171,6 +171,37 @@ void TestAbstractMetaType::testTypedefWithTemplates()
     QCOMPARE(metaType->cppSignature(), QString("A<B >"));
 }
 
+void TestAbstractMetaType::testTranslatedTypesAreIndependentCopies()
+{
+    const char* cppCode ="\
+    template<typename T>\
+    class A {};\
+    \
+    class B {};\
+    \
+    void func1(A<B> a);\
+    void func2(A<B> a);\
+    ";
+    const char* xmlCode = "<typesystem package=\"Foo\">\
+    <container-type name='A' type='list'/>\
+    <value-type name='B' />\
+    <function signature='func1(A&lt;B&gt;)' />\
+    <function signature='func2(A&lt;B&gt;)' />\
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode);
+
+    AbstractMetaFunctionList functions = t.builder()->globalFunctions();
+    QCOMPARE(functions.count(), 2);
+    AbstractMetaType* type1 = functions[0]->arguments().first()->type();
+    AbstractMetaType* type2 = functions[1]->arguments().first()->type();
+    QVERIFY(type1 != type2);
+    QCOMPARE(type1->instantiations().count(), 1);
+    QCOMPARE(type2->instantiations().count(), 1);
+    QVERIFY(type1->instantiations().first() != type2->instantiations().first());
+    QCOMPARE(type1->cppSignature(), QString("A<B >"));
+    QCOMPARE(type2->cppSignature(), QString("A<B >"));
+}
+
 QTEST_APPLESS_MAIN(TestAbstractMetaType)
 
 #include "testabstractmetatype.moc"
@@ -34,6 +34,7 @@ private slots:
     void testCharType();
     void testTypedef();
     void testTypedefWithTemplates();
+    void testTranslatedTypesAreIndependentCopies();
     void testApiVersionSupported();
     void testApiVersionNotSupported();
 };
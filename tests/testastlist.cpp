@@ -0,0 +1,100 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testastlist.h"
+#include <QtTest/QTest>
+#include "list.h"
+
+static const ListNode<int> *buildList(int count, pool *p)
+{
+    const ListNode<int> *list = 0;
+    for (int i = 0; i < count; ++i)
+        list = snoc(list, i * 10, p);
+    return list;
+}
+
+void TestAstList::testFinalizedAccess()
+{
+    pool p;
+    const ListNode<int> *list = finalize(buildList(5, &p), &p);
+    QVERIFY(list->isFinalized());
+    QCOMPARE(list->count(), 5);
+    QCOMPARE(list->toFront()->element, 0);
+    QCOMPARE(list->toBack(), list);
+    for (int i = 0; i < 5; ++i) {
+        QCOMPARE(list->at(i)->element, i * 10);
+        QCOMPARE(list->toFront()->at(i), list->at(i));
+    }
+
+    // The ring links still walk the elements in order
+    const ListNode<int> *it = list->toFront();
+    const ListNode<int> *end = it;
+    int expected = 0;
+    do {
+        QCOMPARE(it->element, expected);
+        expected += 10;
+        it = it->next;
+    } while (it != end);
+    QCOMPARE(expected, 50);
+
+    QCOMPARE(finalize(list, &p), list);
+    QVERIFY(!finalize(static_cast<const ListNode<int> *>(0), &p));
+}
+
+void TestAstList::testAppendAfterFinalize()
+{
+    pool p;
+    const ListNode<int> *list = finalize(buildList(3, &p), &p);
+    list = snoc(list, 30, &p);
+    QVERIFY(!list->isFinalized());
+    QVERIFY(!list->toFront()->isFinalized());
+    QCOMPARE(list->count(), 4);
+    for (int i = 0; i < 4; ++i)
+        QCOMPARE(list->at(i)->element, i * 10);
+
+    list = finalize(list, &p);
+    QVERIFY(list->isFinalized());
+    QCOMPARE(list->count(), 4);
+    QCOMPARE(list->at(3)->element, 30);
+}
+
+void TestAstList::testOversizedAllocation()
+{
+    // More nodes than fit in one 64K pool block
+    const int count = 2 * (rxx_allocator<char>::_S_block_size / sizeof(ListNode<int>));
+    pool p;
+    const ListNode<int> *list = finalize(buildList(count, &p), &p);
+    QCOMPARE(list->count(), count);
+    QCOMPARE(list->toFront()->element, 0);
+    QCOMPARE(list->at(count - 1)->element, (count - 1) * 10);
+
+    // Small allocations keep working after the dedicated block
+    char *small = static_cast<char *>(p.allocate(16));
+    QVERIFY(small);
+    for (int i = 0; i < 16; ++i)
+        QCOMPARE(small[i], char(0));
+    QCOMPARE(list->at(count / 2)->element, (count / 2) * 10);
+}
+
+QTEST_APPLESS_MAIN(TestAstList)
+
+#include "testastlist.moc"
@@ -0,0 +1,128 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testasttoxml.h"
+#include <QtTest/QTest>
+#include <QBuffer>
+#include <QTemporaryFile>
+#include "asttoxml.h"
+
+// Every header ends between two declarations, so that each is bound in a
+// block of its own when streaming with the smallest block size.
+static const char cppCode[] =
+    "# 1 \"a.h\"\n"
+    "namespace N { class A { public: typedef int Id; enum E { E1 }; }; }\n"
+    "# 1 \"b.h\"\n"
+    "class B : public N::A { public: void f(Id id, E e); };\n"
+    "# 1 \"c.h\"\n"
+    "inline void B::f(Id id, E e) {}\n"
+    "class C : public B { public: void g(Id id); };\n"
+    "# 1 \"d.h\"\n"
+    "namespace M { enum { M0 }; class D : public C { public: void h(Id id, N::A::E e); }; }\n";
+
+static QByteArray toXML(const QByteArray &contents, bool streaming, int blockSize = 1)
+{
+    QTemporaryFile file;
+    if (!file.open())
+        return QByteArray();
+    file.write(contents);
+    file.flush();
+
+    QBuffer output;
+    output.open(QIODevice::WriteOnly);
+    astToXML(file.fileName(), &output, streaming, blockSize);
+    return output.data();
+}
+
+// The children of <code>, sorted, as they aren't written in input order
+static QStringList topLevelElements(const QByteArray &xml)
+{
+    QStringList elements;
+    foreach (QString line, QString::fromUtf8(xml).split('\n')) {
+        if (line.startsWith("    <") && !line.startsWith("    </"))
+            elements.append(QString());
+        if (line.startsWith("    "))
+            elements.last() += line + '\n';
+    }
+    elements.sort();
+    return elements;
+}
+
+void TestAstToXml::testStreaming()
+{
+    QStringList parsed = topLevelElements(toXML(cppCode, false));
+    QCOMPARE(parsed.size(), 4);
+
+    // The classes of the earlier blocks still qualify the types inherited
+    // from their base classes.
+    QStringList streamed = topLevelElements(toXML(cppCode, true));
+    QCOMPARE(streamed, parsed);
+    QVERIFY(streamed.filter("name=\"C\"").first().contains("type=\"N::A::Id\""));
+    QVERIFY(streamed.filter("name=\"M\"").first().contains("type=\"N::A::Id\""));
+
+    QCOMPARE(topLevelElements(toXML(cppCode, true, 64 * 1024)), parsed);
+}
+
+void TestAstToXml::testPageSizedInput()
+{
+    // No NUL follows the mapped input when it fills whole pages
+    QByteArray contents(cppCode);
+    contents += QByteArray(8192 - contents.size() - 1, ' ');
+    contents += "\n";
+    QCOMPARE(contents.size(), 8192);
+
+    QStringList parsed = topLevelElements(toXML(contents, false));
+    QCOMPARE(topLevelElements(toXML(contents, true)), parsed);
+    QCOMPARE(topLevelElements(toXML(contents, true, 64 * 1024)), parsed);
+}
+
+// The argument elements, in output order
+static QStringList argumentElements(const QByteArray &xml)
+{
+    QStringList elements;
+    foreach (QString line, QString::fromUtf8(xml).split('\n')) {
+        if (line.trimmed().startsWith("<argument"))
+            elements.append(line.trimmed());
+    }
+    return elements;
+}
+
+void TestAstToXml::testTypeAliasesAcrossBlocks()
+{
+    // The second block declares a member of a class, the only functions
+    // written, in the namespace of the first one's type alias and enum.
+    QByteArray contents =
+        "# 1 \"a.h\"\n"
+        "namespace A { typedef int T; enum E { E1 }; }\n"
+        "# 1 \"b.h\"\n"
+        "namespace A { class B { public: void f(T t, QList<T> l, QList<E> e); }; }\n";
+
+    QStringList parsed = argumentElements(toXML(contents, false));
+    QCOMPARE(parsed.size(), 3);
+    QVERIFY(parsed.first().contains("type=\"A::T\""));
+
+    QCOMPARE(argumentElements(toXML(contents, true)), parsed);
+}
+
+QTEST_APPLESS_MAIN(TestAstToXml)
+
+#include "testasttoxml.moc"
@@ -0,0 +1,172 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testbinderqualify.h"
+#include <QtTest/QTest>
+#include <binder.h>
+#include <control.h>
+#include <parser.h>
+
+// Every class derives from the two previous ones, so the contexts reachable
+// through base classes grow exponentially with the depth when they are not
+// searched only once.
+static const int DEPTH = 24;
+static const int MEMBER_COUNT = 20;
+
+static FileModelItem bind(CodeModel *model, const QByteArray &contents)
+{
+    Control control;
+    Parser p(&control);
+    pool __pool;
+
+    TranslationUnitAST *ast = p.parse(contents, contents.size(), &__pool);
+    Binder binder(model, p.location());
+    return binder.run(ast);
+}
+
+void TestBinderQualify::initTestCase()
+{
+    m_header = "class C0 { public: typedef int Value; class Inner {}; };\n"
+               "class C1 : public C0 {};\n";
+    for (int i = 2; i <= DEPTH; ++i) {
+        m_header += QString("class C%1 : public C%2, public C%3 {\n"
+                            "public:\n").arg(i).arg(i - 1).arg(i - 2).toLatin1();
+        for (int j = 0; j < MEMBER_COUNT; ++j)
+            m_header += QString("    Value method%1(Inner inner, Unknown *unknown);\n").arg(j).toLatin1();
+        m_header += "};\n";
+    }
+}
+
+void TestBinderQualify::testQualifyThroughBaseClasses()
+{
+    CodeModel model;
+    FileModelItem dom = bind(&model, m_header);
+
+    ClassModelItem klass = dom->findClass(QString("C%1").arg(DEPTH));
+    QVERIFY(klass);
+
+    FunctionList functions = klass->findFunctions("method0");
+    QCOMPARE(functions.size(), 1);
+    FunctionModelItem function = functions.first();
+    QCOMPARE(function->type().qualifiedName(), QStringList() << "C0" << "Value");
+
+    ArgumentList arguments = function->arguments();
+    QCOMPARE(arguments.size(), 2);
+    QCOMPARE(arguments.at(0)->type().qualifiedName(), QStringList() << "C0" << "Inner");
+    QCOMPARE(arguments.at(1)->type().qualifiedName(), QStringList() << "Unknown");
+}
+
+void TestBinderQualify::testQualifyThroughQualifiedBaseClasses()
+{
+    QByteArray contents = "namespace N { class A { public: typedef int Id; }; }\n"
+                          "namespace M { class B : public N::A {}; }\n"
+                          "class C : public M::B { public: void f(Id id); };\n"
+                          "namespace M { class D : public B { public: void g(Id id); }; }\n";
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+
+    ClassModelItem c = dom->findClass("C");
+    QVERIFY(c);
+    FunctionList functions = c->findFunctions("f");
+    QCOMPARE(functions.size(), 1);
+    QCOMPARE(functions.first()->arguments().first()->type().qualifiedName(),
+             QStringList() << "N" << "A" << "Id");
+
+    ClassModelItem d = dom->findNamespace("M")->findClass("D");
+    QVERIFY(d);
+    QCOMPARE(d->baseClasses(), QStringList() << "M::B");
+    functions = d->findFunctions("g");
+    QCOMPARE(functions.size(), 1);
+    QCOMPARE(functions.first()->arguments().first()->type().qualifiedName(),
+             QStringList() << "N" << "A" << "Id");
+}
+
+void TestBinderQualify::testQualifyAfterLaterDeclaration()
+{
+    // Both functions qualify T in the same context, before and after it
+    // is declared there.
+    QByteArray contents = "namespace N {\n"
+                          "    class A {};\n"
+                          "    void f(T t, A a);\n"
+                          "    typedef int T;\n"
+                          "    void g(T t, A a);\n"
+                          "}\n";
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+    NamespaceModelItem ns = dom->findNamespace("N");
+    QVERIFY(ns);
+
+    FunctionList functions = ns->findFunctions("f");
+    QCOMPARE(functions.size(), 1);
+    ArgumentList arguments = functions.first()->arguments();
+    QCOMPARE(arguments.at(0)->type().qualifiedName(), QStringList() << "T");
+    QCOMPARE(arguments.at(1)->type().qualifiedName(), QStringList() << "N" << "A");
+
+    functions = ns->findFunctions("g");
+    QCOMPARE(functions.size(), 1);
+    arguments = functions.first()->arguments();
+    QCOMPARE(arguments.at(0)->type().qualifiedName(), QStringList() << "N" << "T");
+    QCOMPARE(arguments.at(1)->type().qualifiedName(), QStringList() << "N" << "A");
+}
+
+void TestBinderQualify::testResolveAfterNewTypeAlias()
+{
+    CodeModel model;
+    FileModelItem dom = bind(&model, "typedef int T;\n"
+                                     "namespace N { class B {}; }\n");
+    NamespaceModelItem ns = dom->findNamespace("N");
+    QVERIFY(ns);
+
+    TypeInfo t;
+    t.setQualifiedName(QStringList() << "T");
+    TypeInfo b;
+    b.setQualifiedName(QStringList() << "B");
+    // Only the given scope is searched, not the enclosing ones.
+    QCOMPARE(model.resolveType(t, ns->toItem()).qualifiedName(), QStringList() << "T");
+    QCOMPARE(model.resolveType(t, dom->toItem()).qualifiedName(), QStringList() << "int");
+    QCOMPARE(model.resolveType(b, ns->toItem()).qualifiedName(), QStringList() << "N" << "B");
+
+    // A result changes once its name is indexed again, and only then.
+    TypeAliasModelItem alias = model.create<TypeAliasModelItem>();
+    alias->setName("T");
+    alias->setScope(QStringList() << "N");
+    TypeInfo aliased;
+    aliased.setQualifiedName(QStringList() << "double");
+    alias->setType(aliased);
+    ns->addTypeAlias(alias);
+
+    QCOMPARE(model.resolveType(t, ns->toItem()).qualifiedName(), QStringList() << "double");
+    QCOMPARE(model.resolveType(t, dom->toItem()).qualifiedName(), QStringList() << "int");
+    QCOMPARE(model.resolveType(b, ns->toItem()).qualifiedName(), QStringList() << "N" << "B");
+}
+
+void TestBinderQualify::benchmarkDeepInheritance()
+{
+    QBENCHMARK {
+        CodeModel model;
+        bind(&model, m_header);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestBinderQualify)
+
+#include "testbinderqualify.moc"
@@ -0,0 +1,195 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testbuildersnapshot.h"
+#include <QtTest/QTest>
+#include <QFile>
+#include <QFileInfo>
+#include "testutil.h"
+
+static const char cppCode[] = "namespace N {"
+                              "    template<typename T> class Base { public: T value; };"
+                              "    class A : public Base<int> {"
+                              "    public:"
+                              "        enum E { E1 = 1, E2 = 2 };"
+                              "        A(int x = 3);"
+                              "        void set(int value);"
+                              "        void set(double value);"
+                              "        void set(E e, double value);"
+                              "    };"
+                              "}";
+
+static const char xmlCode[] = "<typesystem package=\"Foo\">"
+                              "    <primitive-type name=\"int\"/>"
+                              "    <primitive-type name=\"double\"/>"
+                              "    <namespace-type name=\"N\">"
+                              "        <object-type name=\"A\">"
+                              "            <enum-type name=\"E\"/>"
+                              "        </object-type>"
+                              "    </namespace-type>"
+                              "</typesystem>";
+
+static QStringList buildFunctions(const QString &snapshotDir)
+{
+    ReportHandler::setSilent(true);
+    TypeDatabase* td = TypeDatabase::instance(true);
+    QBuffer buffer;
+    buffer.setData(xmlCode);
+    td->parseFile(&buffer);
+    buffer.close();
+
+    AbstractMetaBuilder builder;
+    builder.setSnapshotDirectory(snapshotDir);
+    buffer.setData(cppCode);
+    if (!builder.build(&buffer))
+        return QStringList();
+
+    AbstractMetaClass* a = builder.classes().findClass("N::A");
+    if (!a)
+        return QStringList();
+
+    QStringList signatures;
+    foreach (AbstractMetaFunction* func, a->functions())
+        signatures << func->minimalSignature();
+    return signatures;
+}
+
+static const char enumXmlCode[] = "<typesystem package=\"Foo\">"
+                                  "    <primitive-type name=\"int\"/>"
+                                  "    <enum-type identified-by-value=\"A0\"/>"
+                                  "    <enum-type identified-by-value=\"B0\"/>"
+                                  "    <enum-type identified-by-value=\"C0\"/>"
+                                  "    <object-type name=\"B\"/>"
+                                  "</typesystem>";
+
+// a.h declares anonymous enums before and after the ones of b.h
+static QByteArray enumCppCode(const char *b)
+{
+    QByteArray contents;
+    contents += "# 1 \"a.h\"\n";
+    contents += "enum { A0, A1 };\n";
+    contents += "# 1 \"b.h\"\n";
+    contents += b;
+    contents += "# 2 \"a.h\"\n";
+    contents += "enum { C0, C1 };\n";
+    return contents;
+}
+
+static QStringList buildEnums(const QByteArray &cppCode, const QString &snapshotDir)
+{
+    ReportHandler::setSilent(true);
+    TypeDatabase* td = TypeDatabase::instance(true);
+    QBuffer buffer;
+    buffer.setData(enumXmlCode);
+    td->parseFile(&buffer);
+    buffer.close();
+
+    AbstractMetaBuilder builder;
+    builder.setSnapshotDirectory(snapshotDir);
+    buffer.setData(cppCode);
+    if (!builder.build(&buffer))
+        return QStringList();
+
+    QStringList description;
+    foreach (AbstractMetaEnum* metaEnum, builder.globalEnums()) {
+        QStringList values;
+        foreach (AbstractMetaEnumValue* value, metaEnum->values())
+            values << value->name();
+        description << metaEnum->typeEntry()->qualifiedCppName() + ": " + values.join(", ");
+    }
+    description.sort();
+    if (AbstractMetaClass* b = builder.classes().findClass("B")) {
+        foreach (AbstractMetaFunction* func, b->functions())
+            description << func->minimalSignature();
+    }
+    return description;
+}
+
+void TestBuilderSnapshot::init()
+{
+    m_snapshotDir = QDir(QDir::temp().filePath("testbuildersnapshot"));
+    QVERIFY(QDir::temp().mkpath(m_snapshotDir.path()));
+    foreach (QString entry, m_snapshotDir.entryList(QDir::Files))
+        m_snapshotDir.remove(entry);
+}
+
+void TestBuilderSnapshot::cleanup()
+{
+    foreach (QString entry, m_snapshotDir.entryList(QDir::Files))
+        m_snapshotDir.remove(entry);
+    QDir::temp().rmdir(m_snapshotDir.dirName());
+}
+
+void TestBuilderSnapshot::testReusesSnapshot()
+{
+    QStringList parsed = buildFunctions(m_snapshotDir.path());
+    QCOMPARE(parsed.filter("set(").size(), 3);
+
+    // Only the snapshot and the file naming it are left behind
+    QStringList files = m_snapshotDir.entryList(QDir::Files);
+    QCOMPARE(files.size(), 2);
+    QVERIFY(files.contains("latest"));
+    QStringList snapshots = m_snapshotDir.entryList(QStringList() << "*.cms", QDir::Files);
+    QCOMPARE(snapshots.size(), 1);
+    QFile latest(m_snapshotDir.filePath("latest"));
+    QVERIFY(latest.open(QIODevice::ReadOnly));
+    QCOMPARE(QString::fromLatin1(latest.readAll()), snapshots.first());
+
+    QCOMPARE(buildFunctions(m_snapshotDir.path()), parsed);
+    QCOMPARE(m_snapshotDir.entryList(QDir::Files), files);
+}
+
+void TestBuilderSnapshot::testCorruptSnapshot()
+{
+    QStringList parsed = buildFunctions(m_snapshotDir.path());
+    QStringList snapshots = m_snapshotDir.entryList(QStringList() << "*.cms", QDir::Files);
+    QCOMPARE(snapshots.size(), 1);
+
+    QFile snapshot(m_snapshotDir.filePath(snapshots.first()));
+    qint64 size = snapshot.size();
+    QVERIFY(snapshot.resize(size / 2));
+
+    // The partly read snapshot must not leak into the model parsed instead
+    QCOMPARE(buildFunctions(m_snapshotDir.path()), parsed);
+    QCOMPARE(QFileInfo(snapshot.fileName()).size(), size);
+    QCOMPARE(buildFunctions(m_snapshotDir.path()), parsed);
+}
+
+void TestBuilderSnapshot::testIncrementalUpdate()
+{
+    QByteArray before = enumCppCode("enum { B0, B1 };\n"
+                                    "class B { public: void g(int x); };\n");
+    QByteArray after = enumCppCode("enum { B0, B1, B2 };\n"
+                                   "class B { public: void g(int x); void h(int x); };\n");
+    QStringList parsed = buildEnums(after, QString());
+    QVERIFY(parsed.contains("B0: B0, B1, B2"));
+    QVERIFY(parsed.contains("h(int)"));
+
+    buildEnums(before, m_snapshotDir.path());
+    // Only b.h is parsed again, on top of the snapshot of the first build
+    QCOMPARE(buildEnums(after, m_snapshotDir.path()), parsed);
+    QCOMPARE(m_snapshotDir.entryList(QStringList() << "*.cms", QDir::Files).size(), 2);
+}
+
+QTEST_APPLESS_MAIN(TestBuilderSnapshot)
+
+#include "testbuildersnapshot.moc"
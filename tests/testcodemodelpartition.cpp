@@ -0,0 +1,175 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testcodemodelpartition.h"
+#include <QtTest/QTest>
+#include "binder.h"
+#include "codemodel_partition.h"
+#include "control.h"
+#include "parser.h"
+
+static FileModelItem bind(CodeModel *model, const QByteArray &contents)
+{
+    Control control;
+    Parser p(&control);
+    pool __pool;
+
+    TranslationUnitAST *ast = p.parse(contents, contents.size(), &__pool);
+    Binder binder(model, p.location());
+    return binder.run(ast);
+}
+
+static QByteArray translationUnit(const char *b)
+{
+    QByteArray contents;
+    contents += "# 1 \"a.h\"\n";
+    contents += "namespace N {\n";
+    contents += "# 2 \"a.h\"\n";
+    contents += "class A { public: void f(); };\n";
+    contents += "# 3 \"a.h\"\n";
+    contents += "}\n";
+    contents += "# 1 \"b.h\"\n";
+    contents += b;
+    contents += "# 4 \"a.h\"\n";
+    contents += "namespace N { typedef A *APtr; }\n";
+    return contents;
+}
+
+void TestCodeModelPartition::testFingerprints()
+{
+    CodeModelPartition partition(translationUnit("namespace N { class B { void g(A *a); }; }\n"));
+    QVERIFY(partition.isSelfContained());
+    QCOMPARE(partition.fingerprints().size(), 2);
+
+    CodeModelPartition changed(translationUnit("namespace N { class B { void g(A *a, int i); }; }\n"));
+    QCOMPARE(changed.fingerprints().value("a.h"), partition.fingerprints().value("a.h"));
+    QVERIFY(changed.fingerprints().value("b.h") != partition.fingerprints().value("b.h"));
+
+    QByteArray b = changed.extract(QSet<QString>() << "b.h");
+    QVERIFY(b.startsWith("# 1 \"b.h\"\n"));
+    QVERIFY(b.contains("int i"));
+    QVERIFY(!b.contains("APtr"));
+}
+
+void TestCodeModelPartition::testUpdateChangedFile()
+{
+    QByteArray contents = translationUnit("namespace N { class B { void g(A *a); }; }\n");
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+    CodeModelPartition::FingerprintMap previous = CodeModelPartition(contents).fingerprints();
+
+    ClassModelItem a = dom->findNamespace("N")->findClass("A");
+    QVERIFY(a);
+
+    CodeModelPartition partition(translationUnit("namespace N { class B { void g(A *a, int i); }; }\n"));
+    QVERIFY(partition.update(dom, previous));
+
+    NamespaceModelItem ns = dom->findNamespace("N");
+    QVERIFY(ns);
+    // The items of the unchanged header are kept as they were.
+    QCOMPARE(ns->findClass("A").data(), a.data());
+    QVERIFY(ns->findTypeAlias("APtr"));
+
+    ClassModelItem b = ns->findClass("B");
+    QVERIFY(b);
+    QCOMPARE(b->fileName(), QString("b.h"));
+    FunctionList g = b->findFunctions("g");
+    QCOMPARE(g.size(), 1);
+    QCOMPARE(g.first()->arguments().size(), 2);
+    // The re-bound header still sees the types of the others.
+    QCOMPARE(g.first()->arguments().first()->type().qualifiedName(), QStringList() << "N" << "A");
+    QCOMPARE(model.findItem(QStringList() << "N" << "B", dom->toItem()).data(),
+             static_cast<_CodeModelItem*>(b.data()));
+}
+
+void TestCodeModelPartition::testNotSelfContained()
+{
+    QByteArray contents;
+    contents += "# 1 \"a.h\"\n";
+    contents += "class A {\n";
+    contents += "# 1 \"b.h\"\n";
+    contents += "int b;\n";
+    contents += "# 2 \"a.h\"\n";
+    contents += "};\n";
+
+    CodeModelPartition partition(contents);
+    QVERIFY(!partition.isSelfContained());
+
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+    QVERIFY(!partition.update(dom, CodeModelPartition::FingerprintMap()));
+}
+
+void TestCodeModelPartition::testDeclaredTypesChanged()
+{
+    QByteArray contents = translationUnit("namespace N { class B {}; }\n");
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+    CodeModelPartition::FingerprintMap previous = CodeModelPartition(contents).fingerprints();
+
+    // Declarations of the unchanged headers could now qualify differently.
+    CodeModelPartition partition(translationUnit("namespace N { class C {}; }\n"));
+    QVERIFY(!partition.update(dom, previous));
+}
+
+static QByteArray anonymousEnums(const char *b)
+{
+    QByteArray contents;
+    contents += "# 1 \"a.h\"\n";
+    contents += "namespace N { enum { A0 }; }\n";
+    contents += "# 1 \"b.h\"\n";
+    contents += b;
+    contents += "# 2 \"a.h\"\n";
+    contents += "namespace N { enum { A1 }; }\n";
+    return contents;
+}
+
+void TestCodeModelPartition::testAnonymousEnums()
+{
+    QByteArray contents = anonymousEnums("namespace N { enum { B0 }; }\n");
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+    CodeModelPartition::FingerprintMap previous = CodeModelPartition(contents).fingerprints();
+    QVERIFY(dom->findNamespace("N")->findEnum("enum_2"));
+
+    // The enums of the re-bound header keep the names the others know them by
+    CodeModelPartition partition(anonymousEnums("namespace N { enum { B0, B1 }; }\n"));
+    QVERIFY(partition.update(dom, previous));
+
+    NamespaceModelItem ns = dom->findNamespace("N");
+    QVERIFY(ns);
+    QCOMPARE(ns->enums().size(), 3);
+    QCOMPARE(ns->findEnum("enum_1")->enumerators().first()->name(), QString("A0"));
+    QCOMPARE(ns->findEnum("enum_2")->enumerators().size(), 2);
+    QCOMPARE(ns->findEnum("enum_2")->fileName(), QString("b.h"));
+    QCOMPARE(ns->findEnum("enum_3")->enumerators().first()->name(), QString("A1"));
+
+    // One enum more is numbered after all of them
+    CodeModelPartition added(anonymousEnums("namespace N { enum { B0 }; enum { B1 }; }\n"));
+    QVERIFY(!added.update(dom, partition.fingerprints()));
+    QVERIFY(ns->findEnum("enum_2"));
+    QCOMPARE(ns->findEnum("enum_4")->enumerators().first()->name(), QString("B1"));
+}
+
+QTEST_APPLESS_MAIN(TestCodeModelPartition)
+
+#include "testcodemodelpartition.moc"
@@ -0,0 +1,201 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testcodemodelsnapshot.h"
+#include <QtTest/QTest>
+#include <QtCore/QBuffer>
+#include "binder.h"
+#include "codemodel_snapshot.h"
+#include "control.h"
+#include "parser.h"
+
+static const char cppCode[] = "namespace N {"
+                              "    template<typename T> class Base { public: T value; };"
+                              "    class A : public Base<int> {"
+                              "    public:"
+                              "        enum E { E1 = 1, E2 = 2 };"
+                              "        A(int x = 3);"
+                              "        virtual const char *name() const;"
+                              "        void take(E e, Base<double> *b) {}"
+                              "    };"
+                              "    typedef A *APtr;"
+                              "}";
+
+static FileModelItem bind(CodeModel *model, const QByteArray &contents)
+{
+    Control control;
+    Parser p(&control);
+    pool __pool;
+
+    TranslationUnitAST *ast = p.parse(contents, contents.size(), &__pool);
+    Binder binder(model, p.location());
+    return binder.run(ast);
+}
+
+void TestCodeModelSnapshot::testRoundTrip()
+{
+    QByteArray contents(cppCode);
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(CodeModelSnapshot::save(&buffer, dom, CodeModelSnapshot::fingerprint(contents)));
+    buffer.close();
+
+    buffer.open(QIODevice::ReadOnly);
+    CodeModel loadedModel;
+    FileModelItem loaded = CodeModelSnapshot::load(&buffer, &loadedModel, CodeModelSnapshot::fingerprint(contents));
+    QVERIFY(loaded);
+
+    NamespaceModelItem ns = loaded->findNamespace("N");
+    NamespaceModelItem originalNs = dom->findNamespace("N");
+    QVERIFY(ns);
+    QCOMPARE(ns->classes().size(), 2);
+    QVERIFY(ns->findTypeAlias("APtr"));
+    QCOMPARE(ns->findTypeAlias("APtr")->type().toString(),
+             originalNs->findTypeAlias("APtr")->type().toString());
+
+    // Template classes are also reachable through their short name.
+    QVERIFY(ns->findClass("Base"));
+
+    ClassModelItem a = ns->findClass("A");
+    ClassModelItem originalA = originalNs->findClass("A");
+    QVERIFY(a);
+    QCOMPARE(a->qualifiedName(), QStringList() << "N" << "A");
+    QCOMPARE(a->baseClasses(), originalA->baseClasses());
+
+    // Members added before their scope was attached are still found by
+    // qualified name.
+    QStringList qualifiedEnum = QStringList() << "N" << "A" << "E";
+    QCOMPARE(loadedModel.findItem(qualifiedEnum, loaded->toItem()).data(),
+             static_cast<_CodeModelItem*>(a->findEnum("E").data()));
+
+    EnumModelItem e = a->findEnum("E");
+    QVERIFY(e);
+    QCOMPARE(e->enumerators().size(), 2);
+    QCOMPARE(e->enumerators().last()->value(), originalA->findEnum("E")->enumerators().last()->value());
+
+    FunctionList names = a->findFunctions("name");
+    QCOMPARE(names.size(), 1);
+    QVERIFY(names.first()->isVirtual());
+    QCOMPARE(names.first()->type().toString(),
+             originalA->findFunctions("name").first()->type().toString());
+
+    FunctionList ctors = a->findFunctions("A");
+    QCOMPARE(ctors.size(), 1);
+    QCOMPARE(ctors.first()->arguments().size(), 1);
+    QVERIFY(ctors.first()->arguments().first()->defaultValue());
+    QCOMPARE(ctors.first()->arguments().first()->defaultValueExpression(),
+             originalA->findFunctions("A").first()->arguments().first()->defaultValueExpression());
+
+    // Definitions are also listed as functions, and must stay the same item.
+    FunctionDefinitionList definitions = a->functionDefinitions();
+    QCOMPARE(definitions.size(), 1);
+    QCOMPARE(a->findFunctions("take").first().data(),
+             static_cast<_FunctionModelItem*>(definitions.first().data()));
+}
+
+void TestCodeModelSnapshot::testFingerprintMismatch()
+{
+    QByteArray contents(cppCode);
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(CodeModelSnapshot::save(&buffer, dom, CodeModelSnapshot::fingerprint(contents)));
+    buffer.close();
+
+    buffer.open(QIODevice::ReadOnly);
+    CodeModel loadedModel;
+    QByteArray otherFingerprint = CodeModelSnapshot::fingerprint(contents + "class B {};");
+    QVERIFY(!CodeModelSnapshot::load(&buffer, &loadedModel, otherFingerprint));
+}
+
+template <class _List>
+static QStringList argumentTypes(const _List &functions)
+{
+    QStringList types;
+    for (typename _List::const_iterator it = functions.begin(); it != functions.end(); ++it) {
+        FunctionModelItem function = model_static_cast<FunctionModelItem>(*it);
+        QStringList arguments;
+        foreach (ArgumentModelItem argument, function->arguments())
+            arguments << argument->type().toString();
+        types << arguments.join(",");
+    }
+    return types;
+}
+
+void TestCodeModelSnapshot::testOverloadOrder()
+{
+    QByteArray contents("class C {"
+                        "public:"
+                        "    void f(int);"
+                        "    void f(double);"
+                        "    void f(int, int);"
+                        "    void g() {}"
+                        "    void g(int) {}"
+                        "};");
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(CodeModelSnapshot::save(&buffer, dom, CodeModelSnapshot::fingerprint(contents)));
+    buffer.close();
+
+    buffer.open(QIODevice::ReadOnly);
+    CodeModel loadedModel;
+    FileModelItem loaded = CodeModelSnapshot::load(&buffer, &loadedModel, CodeModelSnapshot::fingerprint(contents));
+    QVERIFY(loaded);
+
+    ClassModelItem original = dom->findClass("C");
+    ClassModelItem c = loaded->findClass("C");
+    QVERIFY(c);
+    QCOMPARE(argumentTypes(c->findFunctions("f")), argumentTypes(original->findFunctions("f")));
+    QCOMPARE(argumentTypes(c->findFunctions("g")), argumentTypes(original->findFunctions("g")));
+    QCOMPARE(argumentTypes(c->findFunctionDefinitions("g")), argumentTypes(original->findFunctionDefinitions("g")));
+    QCOMPARE(c->findFunctions("f").size(), 3);
+}
+
+void TestCodeModelSnapshot::testTruncatedSnapshot()
+{
+    QByteArray contents(cppCode);
+    CodeModel model;
+    FileModelItem dom = bind(&model, contents);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(CodeModelSnapshot::save(&buffer, dom, CodeModelSnapshot::fingerprint(contents)));
+    buffer.close();
+
+    QBuffer truncated;
+    truncated.setData(buffer.data().left(buffer.data().size() / 2));
+    truncated.open(QIODevice::ReadOnly);
+    CodeModel loadedModel;
+    QVERIFY(!CodeModelSnapshot::load(&truncated, &loadedModel, CodeModelSnapshot::fingerprint(contents)));
+}
+
+QTEST_APPLESS_MAIN(TestCodeModelSnapshot)
+
+#include "testcodemodelsnapshot.moc"
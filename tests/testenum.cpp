@@ -373,6 +373,49 @@ void TestEnum::testPrivateEnum()
     QCOMPARE(pub1->stringValue(), QString("A::Priv1"));
 }
 
+void TestEnum::testEnumIndex()
+{
+    const char* cppCode ="\
+    enum GlobalEnum { GlobalA, Shared };\
+    struct A {\
+        enum ClassEnum { ClassA = 3, Shared };\
+    };\
+    struct B {\
+        void method(double[ClassA]);\
+    };\
+    ";
+    const char* xmlCode = "\
+    <typesystem package=\"Foo\"> \
+        <enum-type name='GlobalEnum' />\
+        <value-type name='A'> \
+            <enum-type name='ClassEnum' />\
+        </value-type> \
+        <primitive-type name='double'/>\
+        <object-type name='B'/> \
+    </typesystem>";
+
+    TestUtil t(cppCode, xmlCode);
+    AbstractMetaBuilder* builder = t.builder();
+    AbstractMetaEnum* globalEnum = builder->globalEnums().first();
+    AbstractMetaEnum* classEnum = builder->classes().findClass("A")->enums().first();
+
+    QCOMPARE(builder->findEnum(globalEnum->typeEntry()), globalEnum);
+    QCOMPARE(builder->findEnum(classEnum->typeEntry()), classEnum);
+
+    QCOMPARE(builder->findEnumValue("GlobalA"), globalEnum->values().first());
+    QCOMPARE(builder->findEnumValue("A::ClassA"), classEnum->values().first());
+    QCOMPARE(builder->findEnumValue("ClassA"), classEnum->values().first());
+    // class values take precedence over global ones for bare names
+    QCOMPARE(builder->findEnumValue("Shared"), classEnum->values().last());
+    QVERIFY(!builder->findEnumValue("A::GlobalA"));
+
+    // values of other classes' enums are found through the index while
+    // the class members are traversed
+    const AbstractMetaArgument* arg = builder->classes().findClass("B")->functions().last()->arguments().first();
+    QVERIFY(arg->type()->isArray());
+    QCOMPARE(arg->type()->arrayElementCount(), 3);
+}
+
 QTEST_APPLESS_MAIN(TestEnum)
 
 #include "testenum.moc"
@@ -239,6 +239,65 @@ void TestModifyFunction::testGlobalFunctionModification()
     QCOMPARE(arg->defaultValueExpression(), QString("A()"));
 }
 
+void TestModifyFunction::testInheritedModifications()
+{
+    const char* cppCode ="\
+    struct A {\
+        virtual void call(int *a);\
+    };\
+    struct B : A {\
+    };\
+    struct C : B {\
+    };\
+    ";
+    const char* xmlCode = "\
+    <typesystem package='Foo'> \
+        <primitive-type name='int'/>\
+        <object-type name='A'> \
+        <modify-function signature='call(int*)'>\
+            <modify-argument index='1'>\
+                <rename to='b'/>\
+            </modify-argument>\
+        </modify-function>\
+        </object-type>\
+        <object-type name='B'> \
+        <modify-function signature='call(int*)'>\
+            <modify-argument index='1'>\
+                <remove-default-expression/>\
+            </modify-argument>\
+        </modify-function>\
+        </object-type>\
+        <object-type name='C'/>\
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode, false);
+    AbstractMetaClassList classes = t.builder()->classes();
+    AbstractMetaClass* classA = classes.findClass("A");
+    AbstractMetaClass* classC = classes.findClass("C");
+    const AbstractMetaFunction* funcA = classA->findFunction("call");
+    const AbstractMetaFunction* funcC = classC->findFunction("call");
+    QVERIFY(funcA);
+    QVERIFY(funcC);
+
+    // build() leaves the classes frozen, with the modifications memoized
+    QCOMPARE(funcA->modifications(classA).count(), 1);
+    QCOMPARE(funcA->modifications(classC).count(), 2);
+    QCOMPARE(funcA->modifications(classC).count(), 2);
+    FunctionModificationList frozenMods = funcC->modifications(classC);
+    QVERIFY(!frozenMods.isEmpty());
+
+    // Setting the functions walks the class hierarchy again
+    classC->setFunctions(classC->functions());
+    QCOMPARE(funcA->modifications(classC).count(), 2);
+    QCOMPARE(funcC->modifications(classC), frozenMods);
+
+    // The memo stays on while unfrozen; a new base class anywhere drops it
+    AbstractMetaClass* classB = classes.findClass("B");
+    classB->setBaseClass(0);
+    QCOMPARE(funcA->modifications(classC).count(), 1);
+    classB->setBaseClass(classA);
+    QCOMPARE(funcA->modifications(classC).count(), 2);
+}
+
 QTEST_APPLESS_MAIN(TestModifyFunction)
 
 #include "testmodifyfunction.moc"
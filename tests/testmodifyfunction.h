@@ -35,6 +35,7 @@ class TestModifyFunction : public QObject
         void testRenameArgument();
         void invalidateAfterUse();
         void testGlobalFunctionModification();
+        void testInheritedModifications();
 };
 
 #endif
@@ -82,6 +82,36 @@ void TestNestedTypes::testNestedTypesModifications()
     QVERIFY(removedFunc->isModifiedRemoved());
 }
 
+void TestNestedTypes::testNestedNameTranslatedWithoutClassFirst()
+{
+    // The operator argument is translated without a current class to
+    // find the operator's class, and then again within it, where the
+    // class scope is searched first.
+    const char* cppCode ="\
+    struct Inner {};\
+    struct A { struct Inner {}; };\
+    bool operator==(const A&, Inner);\
+    ";
+    const char* xmlCode = "\
+    <typesystem package='Foo'> \
+        <primitive-type name='bool'/>\
+        <value-type name='Inner'/>\
+        <value-type name='A'>\
+            <value-type name='Inner'/>\
+        </value-type>\
+    </typesystem>";
+
+    TestUtil t(cppCode, xmlCode, false);
+    AbstractMetaClassList classes = t.builder()->classes();
+    AbstractMetaClass* classA = classes.findClass("A");
+    QVERIFY(classA);
+    AbstractMetaFunctionList operators = classA->queryFunctionsByName("operator==");
+    QCOMPARE(operators.count(), 1);
+    AbstractMetaArgumentList arguments = operators.first()->arguments();
+    QCOMPARE(arguments.count(), 1);
+    QCOMPARE(arguments.first()->type()->typeEntry()->qualifiedCppName(), QString("A::Inner"));
+}
+
 QTEST_APPLESS_MAIN(TestNestedTypes)
 
 #include "testnestedtypes.moc"
@@ -108,6 +108,28 @@ void TestNumericalTypedef::testUnsignedNumericalTypedef()
     QVERIFY(ushortType->typeEntry()->isCppPrimitive());
 }
 
+void TestNumericalTypedef::testNormalizedSignature()
+{
+    const char* cppCode ="void func(unsigned short, unsigned int);";
+    const char* xmlCode = "\
+    <typesystem package='Foo'> \
+        <primitive-type name='ushort' /> \
+        <function signature='func(unsigned short, unsigned int)' />\
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode, false);
+
+    TypeDatabase* db = TypeDatabase::instance();
+    const char* signature = "func(unsigned short, unsigned int)";
+    QCOMPARE(db->normalizedSignature(signature), QString("func(ushort,unsigned int)"));
+    // Cached results must match the first computation
+    QCOMPARE(db->normalizedSignature(signature), QString("func(ushort,unsigned int)"));
+    QCOMPARE(db->normalizedSignature("funcuint(uint)"), QString("funcuint(uint)"));
+
+    // Declaring "uint" as a type stops its expansion
+    db->addType(new PrimitiveTypeEntry("uint", 0));
+    QCOMPARE(db->normalizedSignature(signature), QString("func(ushort,uint)"));
+}
+
 QTEST_APPLESS_MAIN(TestNumericalTypedef)
 
 #include "testnumericaltypedef.moc"
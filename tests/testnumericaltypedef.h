@@ -32,6 +32,7 @@ class TestNumericalTypedef : public QObject
     private slots:
         void testNumericalTypedef();
         void testUnsignedNumericalTypedef();
+        void testNormalizedSignature();
 };
 
 #endif
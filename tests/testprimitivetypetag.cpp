@@ -49,6 +49,54 @@ void TestPrimitiveTypeTag::testPrimitiveTypeDefaultConstructor()
     QCOMPARE(typeEntry->defaultConstructor(), QString("A()"));
 }
 
+void TestPrimitiveTypeTag::testKindSpecificLookups()
+{
+    const char* cppCode ="\
+    struct A {};\
+    struct B {};\
+    namespace N { enum Option { O1 }; }\
+    ";
+    const char* xmlCode = "\
+    <typesystem package=\"Foo\"> \
+        <primitive-type name='A' target-lang-name='Alpha'/> \
+        <object-type name='B' /> \
+        <namespace-type name='N'> \
+            <enum-type name='Option' flags='Options' /> \
+        </namespace-type> \
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode, false);
+    TypeDatabase* db = TypeDatabase::instance();
+
+    PrimitiveTypeEntry* primitiveA = db->findPrimitiveType("A");
+    QVERIFY(primitiveA);
+    QCOMPARE(db->findTargetLangPrimitiveType("Alpha"), primitiveA);
+    QVERIFY(!db->findTargetLangPrimitiveType("A"));
+    QVERIFY(!db->findComplexType("A"));
+
+    ObjectTypeEntry* objectB = db->findObjectType("B");
+    QVERIFY(objectB);
+    QCOMPARE(db->findComplexType("B"), static_cast<ComplexTypeEntry*>(objectB));
+    QVERIFY(!db->findPrimitiveType("B"));
+    QVERIFY(!db->findNamespaceType("B"));
+
+    QVERIFY(db->findNamespaceType("N"));
+    QVERIFY(!db->findObjectType("N"));
+
+    FlagsTypeEntry* flags = db->findFlagsType("N::Options");
+    QVERIFY(flags);
+    QCOMPARE(db->findFlagsType("Options"), flags);
+    QVERIFY(!db->findFlagsType("ptions"));
+
+    // containers and functions are only found by the first entry of a name
+    db->addType(new ContainerTypeEntry("Plain", ContainerTypeEntry::ListContainer, 0));
+    QVERIFY(db->findContainerType("Plain<int>"));
+    db->addType(new ObjectTypeEntry("Shadowed", 0));
+    db->addType(new ContainerTypeEntry("Shadowed", ContainerTypeEntry::ListContainer, 0));
+    QVERIFY(!db->findContainerType("Shadowed<int>"));
+    db->addType(new FunctionTypeEntry("Shadowed", "Shadowed()", 0));
+    QVERIFY(!db->findFunctionType("Shadowed"));
+}
+
 QTEST_APPLESS_MAIN(TestPrimitiveTypeTag)
 
 #include "testprimitivetypetag.moc"
@@ -31,6 +31,7 @@ class TestPrimitiveTypeTag : public QObject
     Q_OBJECT
     private slots:
         void testPrimitiveTypeDefaultConstructor();
+        void testKindSpecificLookups();
 };
 
 #endif
@@ -0,0 +1,177 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testqueryfunctions.h"
+#include <QtTest/QTest>
+#include <QThreadPool>
+#include <QRunnable>
+#include "testutil.h"
+
+// The queries the generators run most often
+static const uint VirtualQuery = AbstractMetaClass::VirtualFunctions
+                                 | AbstractMetaClass::NotRemovedFromTargetLang;
+static const uint SignalQuery = AbstractMetaClass::Signals
+                                | AbstractMetaClass::Visible
+                                | AbstractMetaClass::NotRemovedFromTargetLang;
+static const uint ShellQuery = AbstractMetaClass::NormalFunctions
+                               | AbstractMetaClass::Visible
+                               | AbstractMetaClass::WasVisible
+                               | AbstractMetaClass::NotRemovedFromShell
+                               | AbstractMetaClass::VirtualFunctions;
+
+void TestQueryFunctions::initTestCase()
+{
+    QByteArray cppCode = "class A {\npublic:\n    A();\n    A(int);\n";
+    for (int i = 0; i < 100; ++i) {
+        QByteArray n = QByteArray::number(i);
+        cppCode += "    virtual void virtualMethod" + n + "(int);\n";
+        cppCode += "    void method" + n + "();\n";
+        cppCode += "    static int staticMethod" + n + "(int, int);\n";
+    }
+    cppCode += "protected:\n";
+    for (int i = 0; i < 50; ++i)
+        cppCode += "    void protectedMethod" + QByteArray::number(i) + "();\n";
+    cppCode += "private:\n";
+    for (int i = 0; i < 50; ++i)
+        cppCode += "    void privateMethod" + QByteArray::number(i) + "();\n";
+    cppCode += "};\n";
+
+    const char* xmlCode = "\
+    <typesystem package=\"Foo\"> \
+        <primitive-type name='int'/> \
+        <object-type name='A'/> \
+    </typesystem>";
+    m_util = new TestUtil(cppCode.constData(), xmlCode);
+    m_class = m_util->builder()->classes().findClass("A");
+    QVERIFY(m_class);
+    QVERIFY(m_class->functions().size() > 400);
+}
+
+void TestQueryFunctions::cleanupTestCase()
+{
+    delete m_util;
+}
+
+void TestQueryFunctions::testTemplateMatchesRuntimeQuery()
+{
+    // Setting the functions drops the masks computed at the end of build()
+    m_class->setFunctions(m_class->functions());
+
+    QCOMPARE(m_class->queryFunctions<VirtualQuery>(), m_class->queryFunctions(VirtualQuery));
+    QCOMPARE(m_class->queryFunctions<SignalQuery>(), m_class->queryFunctions(SignalQuery));
+    QCOMPARE(m_class->queryFunctions<ShellQuery>(), m_class->queryFunctions(ShellQuery));
+    QCOMPARE(m_class->queryFunctions<AbstractMetaClass::Constructors>(),
+             m_class->queryFunctions(AbstractMetaClass::Constructors));
+    QCOMPARE(m_class->queryFunctions<AbstractMetaClass::Invisible>(),
+             m_class->queryFunctions(AbstractMetaClass::Invisible));
+    QCOMPARE(m_class->queryFunctions<AbstractMetaClass::StaticFunctions>(),
+             m_class->queryFunctions(AbstractMetaClass::StaticFunctions));
+    QCOMPARE(m_class->queryFunctions<0>(), m_class->queryFunctions(0));
+
+    QCOMPARE(m_class->queryFunctions<VirtualQuery>().size(), 100);
+    QCOMPARE(m_class->queryFunctions<AbstractMetaClass::StaticFunctions>().size(), 100);
+
+    m_class->freezeFunctionQueries();
+    QCOMPARE(m_class->queryFunctions<VirtualQuery>().size(), 100);
+}
+
+void TestQueryFunctions::testFrozenMatchesEveryOption()
+{
+    QList<uint> queries;
+    queries << 0 << VirtualQuery << SignalQuery << ShellQuery;
+    for (uint option = AbstractMetaClass::Constructors; option <= AbstractMetaClass::OperatorOverloads; option <<= 1)
+        queries << option << (option | AbstractMetaClass::Visible);
+
+    m_class->setFunctions(m_class->functions());
+    QList<AbstractMetaFunctionList> expected;
+    foreach (uint query, queries)
+        expected << m_class->queryFunctions(query);
+
+    m_class->freezeFunctionQueries();
+    for (int i = 0; i < queries.size(); ++i)
+        QCOMPARE(m_class->queryFunctions(queries.at(i)), expected.at(i));
+}
+
+class FrozenQuery : public QRunnable
+{
+public:
+    FrozenQuery(const AbstractMetaClass* cls, QAtomicInt* failures) : m_class(cls), m_failures(failures) {}
+
+    void run()
+    {
+        // options above OperatorOverloads filter nothing, but each query
+        // is memoized on its own
+        for (uint query = 0; query < 32; ++query) {
+            if (m_class->queryFunctions(VirtualQuery | (query << 26)).size() != 100)
+                m_failures->ref();
+            if (m_class->functions().first()->modifications(m_class).size() != 0)
+                m_failures->ref();
+        }
+    }
+
+private:
+    const AbstractMetaClass* m_class;
+    QAtomicInt* m_failures;
+};
+
+void TestQueryFunctions::testConcurrentFrozenQueries()
+{
+    // the memos are filled from const methods on several threads
+    m_class->freezeFunctionQueries();
+    QAtomicInt failures(0);
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    for (int i = 0; i < 8; ++i)
+        pool.start(new FrozenQuery(m_class, &failures));
+    pool.waitForDone();
+    QCOMPARE(int(failures), 0);
+}
+
+void TestQueryFunctions::benchmarkRuntimeQuery()
+{
+    m_class->setFunctions(m_class->functions());
+    uint query = ShellQuery;
+    QBENCHMARK {
+        m_class->queryFunctions(query);
+    }
+}
+
+void TestQueryFunctions::benchmarkTemplateQuery()
+{
+    m_class->setFunctions(m_class->functions());
+    QBENCHMARK {
+        m_class->queryFunctions<ShellQuery>();
+    }
+}
+
+void TestQueryFunctions::benchmarkFrozenQuery()
+{
+    m_class->freezeFunctionQueries();
+    uint query = ShellQuery;
+    QBENCHMARK {
+        m_class->queryFunctions(query);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestQueryFunctions)
+
+#include "testqueryfunctions.moc"
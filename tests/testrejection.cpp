@@ -0,0 +1,133 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testrejection.h"
+#include <QtTest/QTest>
+#include "testutil.h"
+
+void TestRejection::testRejectionKinds()
+{
+    TypeDatabase* td = TypeDatabase::instance(true);
+    td->addRejection("A", "*", "*", "*");
+    td->addRejection("B", "method", "*", "*");
+    td->addRejection("B", "*", "field", "*");
+    td->addRejection("B", "*", "*", "Enum");
+
+    QVERIFY(td->isClassRejected("A"));
+    QVERIFY(!td->isClassRejected("B"));
+
+    QVERIFY(td->isFunctionRejected("B", "method"));
+    QVERIFY(!td->isFunctionRejected("B", "other"));
+    QVERIFY(!td->isFunctionRejected("C", "method"));
+
+    QVERIFY(td->isFieldRejected("B", "field"));
+    QVERIFY(!td->isFieldRejected("B", "method"));
+
+    QVERIFY(td->isEnumRejected("B", "Enum"));
+    QVERIFY(!td->isEnumRejected("A", "Enum"));
+}
+
+void TestRejection::testWildcardClass()
+{
+    TypeDatabase* td = TypeDatabase::instance(true);
+    td->addRejection("*", "qt_metacall", "*", "*");
+    td->addRejection("*", "*", "d_ptr", "*");
+
+    QVERIFY(td->isFunctionRejected("A", "qt_metacall"));
+    QVERIFY(td->isFunctionRejected("B", "qt_metacall"));
+    QVERIFY(!td->isFunctionRejected("B", "metacall"));
+    QVERIFY(td->isFieldRejected("Any", "d_ptr"));
+    QVERIFY(!td->isClassRejected("*"));
+}
+
+void TestRejection::testTypesystemRejection()
+{
+    const char* cppCode ="\
+    struct A {\
+        void method();\
+        void rejected();\
+        int field;\
+        int rejectedField;\
+    };\
+    struct B {};\
+    ";
+    const char* xmlCode = "\
+    <typesystem package='Foo'> \
+        <primitive-type name='int'/>\
+        <rejection class='*' function-name='rejected'/>\
+        <rejection class='A' field-name='rejectedField'/>\
+        <rejection class='B'/>\
+        <value-type name='A'/>\
+        <value-type name='B'/>\
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode);
+    AbstractMetaClassList classes = t.builder()->classes();
+    QCOMPARE(classes.count(), 1);
+    AbstractMetaClass* classA = classes.findClass("A");
+    QVERIFY(classA);
+    QVERIFY(classA->findFunction("method"));
+    QVERIFY(!classA->findFunction("rejected"));
+    QCOMPARE(classA->fields().count(), 1);
+    QCOMPARE(classA->fields().first()->name(), QString("field"));
+}
+
+void TestRejection::benchmarkRejectionLookup()
+{
+    // A typesystem for a large library: hundreds of rejections, most of
+    // them for members of specific classes
+    TypeDatabase* td = TypeDatabase::instance(true);
+    for (int i = 0; i < 500; ++i) {
+        QString className = QString("Class%1").arg(i);
+        td->addRejection(className, QString("function%1").arg(i), "*", "*");
+        td->addRejection(className, "*", QString("field%1").arg(i), "*");
+    }
+    for (int i = 0; i < 50; ++i)
+        td->addRejection("*", QString("internal%1").arg(i), "*", "*");
+    for (int i = 0; i < 100; ++i)
+        td->addRejection(QString("Rejected%1").arg(i), "*", "*", "*");
+
+    QStringList classNames;
+    QStringList functionNames;
+    for (int i = 0; i < 100; ++i) {
+        classNames << QString("Class%1").arg(i * 7);
+        functionNames << QString("function%1").arg(i * 5);
+    }
+
+    int rejected = 0;
+    QBENCHMARK {
+        rejected = 0;
+        for (int i = 0; i < classNames.size(); ++i) {
+            if (td->isClassRejected(classNames.at(i)))
+                ++rejected;
+            for (int j = 0; j < functionNames.size(); ++j) {
+                if (td->isFunctionRejected(classNames.at(i), functionNames.at(j)))
+                    ++rejected;
+            }
+        }
+    }
+    // ClassN rejects functionN; i * 7 == j * 5 for i = 0, 5, ..., 70
+    QCOMPARE(rejected, 15);
+}
+
+QTEST_APPLESS_MAIN(TestRejection)
+
+#include "testrejection.moc"
@@ -52,6 +52,44 @@ void TestResolveType::testResolveReturnTypeFromParentScope()
     QVERIFY(meth);
 }
 
+void TestResolveType::testResolveTypedefChain()
+{
+    const char* cppCode = "\
+    typedef int Int;\
+    typedef const Int *IntPtr;\
+    namespace A {\
+        typedef IntPtr Ptr;\
+        struct B {\
+            void method(Ptr p);\
+            void other(Ptr &p);\
+        };\
+    };";
+    const char* xmlCode = "\
+    <typesystem package='Foo'> \
+        <primitive-type name='int' />\
+        <namespace-type name='A' />\
+        <value-type name='A::B' /> \
+    </typesystem>";
+    TestUtil t(cppCode, xmlCode);
+    AbstractMetaClassList classes = t.builder()->classes();
+    AbstractMetaClass* classB = classes.findClass("A::B");
+    QVERIFY(classB);
+
+    const AbstractMetaFunction* meth = classB->findFunction("method");
+    QVERIFY(meth);
+    QCOMPARE(meth->arguments().count(), 1);
+    const AbstractMetaType* type = meth->arguments().first()->type();
+    QCOMPARE(type->cppSignature(), QString("const int *"));
+
+    // Resolving the same typedef again must add the new modifiers only.
+    const AbstractMetaFunction* other = classB->findFunction("other");
+    QVERIFY(other);
+    type = other->arguments().first()->type();
+    QVERIFY(type->isReference());
+    QCOMPARE(type->indirections(), 1);
+    QVERIFY(type->isConstant());
+}
+
 QTEST_APPLESS_MAIN(TestResolveType)
 
 #include "testresolvetype.moc"
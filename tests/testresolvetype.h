@@ -31,6 +31,7 @@ class TestResolveType : public QObject
     Q_OBJECT
     private slots:
         void testResolveReturnTypeFromParentScope();
+        void testResolveTypedefChain();
 };
 
 #endif
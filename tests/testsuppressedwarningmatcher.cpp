@@ -0,0 +1,96 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testsuppressedwarningmatcher.h"
+#include <QtTest/QTest>
+#include <suppressedwarningmatcher.h>
+
+void TestSuppressedWarningMatcher::testMatches_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("literal") << QString("unmatched type 'Foo'") << QString("skipping function 'f', unmatched type 'Foo'") << true;
+    QTest::newRow("literal mismatch") << QString("unmatched type 'Foo'") << QString("unmatched type 'Bar'") << false;
+    QTest::newRow("glob") << QString("skipping*unmatched*'Foo'") << QString("skipping function 'f', unmatched type 'Foo'") << true;
+    QTest::newRow("glob out of order") << QString("unmatched*skipping") << QString("skipping function 'f', unmatched type 'Foo'") << false;
+    QTest::newRow("overlapping segments") << QString("abc*bcd") << QString("abcd") << true;
+    QTest::newRow("repeated segment") << QString("ab*ab") << QString("xaby") << true;
+    QTest::newRow("escaped asterisk") << QString("operator\\*") << QString("skipping 'operator*'") << true;
+    QTest::newRow("escaped asterisk mismatch") << QString("operator\\*") << QString("skipping 'operator+'") << false;
+    QTest::newRow("only asterisks") << QString("**") << QString("anything") << false;
+    QTest::newRow("empty text") << QString("a*b") << QString("") << false;
+}
+
+void TestSuppressedWarningMatcher::testMatches()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, text);
+    QFETCH(bool, matches);
+
+    SuppressedWarningMatcher matcher;
+    matcher.addPattern("an unrelated warning");
+    matcher.addPattern(pattern);
+    QCOMPARE(matcher.matches(text), matches);
+    // second time from the decision cache
+    QCOMPARE(matcher.matches(text), matches);
+}
+
+void TestSuppressedWarningMatcher::testAddPatternAfterMatching()
+{
+    SuppressedWarningMatcher matcher;
+    matcher.addPattern("class 'A'");
+    QVERIFY(!matcher.matches("enum 'B' not found"));
+    matcher.addPattern("enum*not found");
+    QVERIFY(matcher.matches("enum 'B' not found"));
+    QCOMPARE(matcher.patterns().size(), 2);
+}
+
+void TestSuppressedWarningMatcher::benchmarkMatching()
+{
+    // Hundreds of suppressions, as carried by the type systems of large modules
+    SuppressedWarningMatcher matcher;
+    for (int i = 0; i < 300; ++i)
+        matcher.addPattern(QString("skipping function 'Class%1::*', unmatched*type 'Type%1'").arg(i));
+    for (int i = 0; i < 100; ++i)
+        matcher.addPattern(QString("enum 'Enum%1' does not have a type entry").arg(i));
+
+    QStringList texts;
+    for (int i = 0; i < 1000; ++i) {
+        texts << QString("skipping function 'Class%1::method%2', unmatched parameter type 'Type%1'").arg(i % 600).arg(i);
+    }
+
+    int suppressed = 0;
+    QBENCHMARK {
+        suppressed = 0;
+        foreach (const QString& text, texts) {
+            if (matcher.matches(text))
+                ++suppressed;
+        }
+    }
+    QCOMPARE(suppressed, 600);
+}
+
+QTEST_APPLESS_MAIN(TestSuppressedWarningMatcher)
+
+#include "testsuppressedwarningmatcher.moc"
@@ -0,0 +1,212 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testthreadedlookup.h"
+#include <QtTest/QTest>
+#include <QThreadPool>
+#include "testutil.h"
+
+static const char cppCode[] = "\
+    class QObject {};\
+    class A : public QObject {\
+    public:\
+        class Inner {};\
+    };\
+    class B : public A {};\
+    class C {};\
+    class Rejected {};\
+    namespace N { class D {}; }\
+    ";
+
+static const char xmlCode[] = "\
+    <typesystem package='Foo'>\
+        <object-type name='QObject'/>\
+        <object-type name='A'>\
+            <value-type name='Inner'/>\
+        </object-type>\
+        <object-type name='B'/>\
+        <object-type name='C'/>\
+        <rejection class='Rejected'/>\
+        <namespace-type name='N'>\
+            <value-type name='D'/>\
+        </namespace-type>\
+    </typesystem>";
+
+static QStringList build(int threadCount, QMap<QString, bool> *qobjects)
+{
+    ReportHandler::setSilent(true);
+    TypeDatabase* td = TypeDatabase::instance(true);
+    QBuffer buffer;
+    buffer.setData(xmlCode);
+    td->parseFile(&buffer);
+    buffer.close();
+
+    AbstractMetaBuilder builder;
+    builder.setThreadCount(threadCount);
+    buffer.setData(cppCode);
+    if (!builder.build(&buffer))
+        return QStringList();
+
+    QStringList names;
+    foreach (AbstractMetaClass* cls, builder.classes()) {
+        names << cls->qualifiedCppName();
+        if (cls->typeEntry()->isObject())
+            qobjects->insert(cls->qualifiedCppName(), static_cast<const ObjectTypeEntry*>(cls->typeEntry())->isQObject());
+    }
+    names.sort();
+    return names;
+}
+
+void TestThreadedLookup::testSameClassesAsSequential()
+{
+    QMap<QString, bool> sequentialQObjects;
+    QStringList sequential = build(1, &sequentialQObjects);
+    QVERIFY(sequential.contains("A::Inner"));
+    QVERIFY(sequential.contains("N::D"));
+    QVERIFY(!sequential.contains("Rejected"));
+    QVERIFY(sequentialQObjects.value("B"));
+    QVERIFY(!sequentialQObjects.value("C"));
+
+    QMap<QString, bool> threadedQObjects;
+    QStringList threaded = build(4, &threadedQObjects);
+    QCOMPARE(threaded, sequential);
+    QCOMPARE(threadedQObjects, sequentialQObjects);
+}
+
+static QMap<QString, QStringList> buildFunctions(int threadCount)
+{
+    const char cppCode[] = "\
+    struct Value {};\
+    struct Base { virtual void a(); virtual void b(int);\
+                  virtual int f(int); virtual double f(double); virtual Value g(const Value&, double); };\
+    struct Left : Base { void a(); void c(); };\
+    struct Right : Base { void b(int); double f(double); };\
+    struct Top : Base { int f(int); };\
+    struct Bottom : Base { Value g(const Value&, double); };\
+    struct Middle : Base { int f(int); double f(double); };\
+    struct LeftLeft : Left { void c(); void d(); };\
+    struct Other { void e(); };\
+    ";
+    const char xmlCode[] = "\
+    <typesystem package='Foo'>\
+        <primitive-type name='int'/>\
+        <primitive-type name='double'/>\
+        <value-type name='Value'/>\
+        <object-type name='Base'/>\
+        <object-type name='Left'/>\
+        <object-type name='Right'/>\
+        <object-type name='Top'/>\
+        <object-type name='Bottom'/>\
+        <object-type name='Middle'/>\
+        <object-type name='LeftLeft'>\
+            <modify-function signature='d()' rename='renamedD'/>\
+        </object-type>\
+        <object-type name='Other'/>\
+    </typesystem>";
+
+    ReportHandler::setSilent(true);
+    TypeDatabase* td = TypeDatabase::instance(true);
+    QBuffer buffer;
+    buffer.setData(xmlCode);
+    td->parseFile(&buffer);
+    buffer.close();
+
+    AbstractMetaBuilder builder;
+    builder.setThreadCount(threadCount);
+    buffer.setData(cppCode);
+    if (!builder.build(&buffer))
+        return QMap<QString, QStringList>();
+
+    QMap<QString, QStringList> functions;
+    foreach (AbstractMetaClass* cls, builder.classes()) {
+        QStringList signatures;
+        foreach (AbstractMetaFunction* func, cls->functions())
+            signatures << func->implementingClass()->name() + "::" + func->modifiedName() + "/" + func->minimalSignature()
+                          + (func->type() ? " -> " + func->type()->name() : QString());
+        signatures.sort();
+        functions.insert(cls->name(), signatures);
+    }
+    return functions;
+}
+
+void TestThreadedLookup::testFixFunctionsByLevel()
+{
+    QMap<QString, QStringList> sequential = buildFunctions(1);
+    // inherited through fixFunctions()
+    QVERIFY(!sequential.value("LeftLeft").filter("/b(int)").isEmpty());
+    QVERIFY(!sequential.value("LeftLeft").filter("renamedD").isEmpty());
+    // siblings sharing the overloads of Base
+    QVERIFY(sequential.value("Top").contains("Top::f/f(int) -> int"));
+    QVERIFY(sequential.value("Top").contains("Base::f/f(double) -> double"));
+    QVERIFY(sequential.value("Bottom").contains("Bottom::g/g(Value,double) -> Value"));
+
+    QCOMPARE(buildFunctions(4), sequential);
+}
+
+class FrozenQueries : public QRunnable
+{
+public:
+    FrozenQueries(QAtomicInt* failures) : m_failures(failures) {}
+
+    void run()
+    {
+        TypeDatabase* td = TypeDatabase::instance();
+        for (int i = 0; i < 200; ++i) {
+            bool ok = td->findObjectType("B")
+                      && td->findComplexType("N::D")
+                      && !td->findObjectType("N")
+                      && td->isClassRejected("Rejected")
+                      && !td->isSuppressedWarning(QString("warning %1").arg(i))
+                      && TypeDatabase::normalizedSignature("f(unsigned int)") == "f(uint)";
+            if (!ok)
+                m_failures->ref();
+        }
+    }
+
+private:
+    QAtomicInt* m_failures;
+};
+
+void TestThreadedLookup::testFrozenDatabaseQueries()
+{
+    QMap<QString, bool> qobjects;
+    build(1, &qobjects);
+    TypeDatabase* td = TypeDatabase::instance();
+    td->addType(new PrimitiveTypeEntry("uint", 0));
+    td->addSuppressedWarning("skipped *");
+    QVERIFY(!td->isFrozen());
+    td->freeze();
+    QVERIFY(td->isFrozen());
+
+    QAtomicInt failures(0);
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    for (int i = 0; i < 8; ++i)
+        pool.start(new FrozenQueries(&failures));
+    pool.waitForDone();
+    QCOMPARE(int(failures), 0);
+    QVERIFY(td->isSuppressedWarning("skipped this one"));
+}
+
+QTEST_APPLESS_MAIN(TestThreadedLookup)
+
+#include "testthreadedlookup.moc"
@@ -0,0 +1,91 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*/
+
+#include "testtypeparser.h"
+#include <QtTest/QTest>
+#include <typeparser.h>
+
+void TestTypeParser::testSimpleType()
+{
+    TypeParser::Info info = TypeParser::parse("const unsigned int*&");
+    QCOMPARE(info.qualified_name, QStringList() << "unsigned int");
+    QVERIFY(info.is_constant);
+    QVERIFY(info.is_reference);
+    QCOMPARE(int(info.indirections), 1);
+    QVERIFY(!info.is_busted);
+    QCOMPARE(info.toString(), QString("const unsigned int*&"));
+}
+
+void TestTypeParser::testTemplateInstantiations()
+{
+    TypeParser::Info info = TypeParser::parse("QMap<QString, QList< ::Foo::Bar*> >");
+    QCOMPARE(info.qualified_name, QStringList() << "QMap");
+    QCOMPARE(info.template_instantiations.count(), 2);
+    QCOMPARE(info.template_instantiations[0].qualified_name, QStringList() << "QString");
+
+    const TypeParser::Info &list = info.template_instantiations[1];
+    QCOMPARE(list.qualified_name, QStringList() << "QList");
+    QCOMPARE(list.template_instantiations.count(), 1);
+    QCOMPARE(list.template_instantiations[0].qualified_name, QStringList() << "Foo" << "Bar");
+    QCOMPARE(int(list.template_instantiations[0].indirections), 1);
+    QCOMPARE(info.instantiationName(), QString("QMap< QString, QList< Foo::Bar* > >"));
+}
+
+void TestTypeParser::testArrays()
+{
+    TypeParser::Info info = TypeParser::parse("int[3][4]");
+    QCOMPARE(info.qualified_name, QStringList() << "int");
+    QCOMPARE(info.arrays, QStringList() << "3" << "4");
+}
+
+void TestTypeParser::testFunctionPointerIsBusted()
+{
+    TypeParser::Info info = TypeParser::parse("void (*)(int)");
+    QVERIFY(info.is_busted);
+}
+
+void TestTypeParser::testUnbalancedTemplateIsBusted()
+{
+    QVERIFY(TypeParser::parse("int>").is_busted);
+    QVERIFY(TypeParser::parse("int, char").is_busted);
+    QVERIFY(TypeParser::parse("QList<int> >").is_busted);
+    QVERIFY(!TypeParser::parse("QList<int>").is_busted);
+}
+
+void TestTypeParser::testRepeatedParseIsEqual()
+{
+    QString type("QList<QPair<int, QString> >");
+    TypeParser::Info first = TypeParser::parse(type);
+    // Callers may modify the result without affecting later parses
+    first.template_instantiations.clear();
+    first.qualified_name << "Changed";
+
+    TypeParser::Info second = TypeParser::parse(type);
+    QCOMPARE(second.qualified_name, QStringList() << "QList");
+    QCOMPARE(second.template_instantiations.count(), 1);
+    QCOMPARE(second.toString(), TypeParser::parse(QString(type)).toString());
+    QCOMPARE(second.toString(), QString("QList< QPair< int, QString > >"));
+}
+
+QTEST_APPLESS_MAIN(TestTypeParser)
+
+#include "testtypeparser.moc"
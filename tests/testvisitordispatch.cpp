@@ -0,0 +1,192 @@
+/*
+* This file is part of the API Extractor project.
+*
+* Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+*
+* Contact: PySide team <contact@pyside.org>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301 USA
+*
+*/
+
+#include "testvisitordispatch.h"
+#include <QtTest/QTest>
+#include <default_visitor.h>
+#include <static_visitor.h>
+
+static const int CLASS_COUNT = 200;
+static const int MEMBER_COUNT = 100;
+
+class TableNameCounter : public DefaultVisitor
+{
+public:
+    TableNameCounter() : count(0) {}
+
+    int count;
+
+protected:
+    virtual void visitName(NameAST *node)
+    {
+        ++count;
+        DefaultVisitor::visitName(node);
+    }
+};
+
+class StaticNameCounter : public StaticVisitor<StaticNameCounter>
+{
+    friend class StaticVisitor<StaticNameCounter>;
+
+public:
+    StaticNameCounter() : count(0) {}
+
+    int count;
+
+protected:
+    void visitName(NameAST *node)
+    {
+        ++count;
+        StaticVisitor<StaticNameCounter>::visitName(node);
+    }
+};
+
+class TableNodeCounter : public DefaultVisitor
+{
+public:
+    TableNodeCounter() : count(0) {}
+
+    int count;
+
+    virtual void visit(AST *node)
+    {
+        if (node)
+            ++count;
+        DefaultVisitor::visit(node);
+    }
+};
+
+class StaticNodeCounter : public StaticVisitor<StaticNodeCounter>
+{
+public:
+    StaticNodeCounter() : count(0) {}
+
+    int count;
+
+    void visit(AST *node)
+    {
+        if (node)
+            ++count;
+        StaticVisitor<StaticNodeCounter>::visit(node);
+    }
+};
+
+static NameAST *createName(pool *p)
+{
+    NameAST *name = CreateNode<NameAST>(p);
+    name->unqualified_name = CreateNode<UnqualifiedNameAST>(p);
+    return name;
+}
+
+// Builds "class C { T m; ... };" repeated CLASS_COUNT times, each class
+// having MEMBER_COUNT data members.
+static TranslationUnitAST *createTranslationUnit(pool *p)
+{
+    TranslationUnitAST *unit = CreateNode<TranslationUnitAST>(p);
+
+    for (int i = 0; i < CLASS_COUNT; ++i) {
+        ClassSpecifierAST *klass = CreateNode<ClassSpecifierAST>(p);
+        klass->name = createName(p);
+
+        for (int j = 0; j < MEMBER_COUNT; ++j) {
+            SimpleTypeSpecifierAST *type = CreateNode<SimpleTypeSpecifierAST>(p);
+            type->name = createName(p);
+
+            DeclaratorAST *declarator = CreateNode<DeclaratorAST>(p);
+            declarator->id = createName(p);
+
+            InitDeclaratorAST *init = CreateNode<InitDeclaratorAST>(p);
+            init->declarator = declarator;
+
+            SimpleDeclarationAST *member = CreateNode<SimpleDeclarationAST>(p);
+            member->type_specifier = type;
+            member->init_declarators = finalize(snoc<InitDeclaratorAST*>(0, init, p), p);
+
+            klass->member_specs = snoc<DeclarationAST*>(klass->member_specs, member, p);
+        }
+        klass->member_specs = finalize(klass->member_specs, p);
+
+        SimpleDeclarationAST *declaration = CreateNode<SimpleDeclarationAST>(p);
+        declaration->type_specifier = klass;
+        unit->declarations = snoc<DeclarationAST*>(unit->declarations, declaration, p);
+    }
+    unit->declarations = finalize(unit->declarations, p);
+
+    return unit;
+}
+
+void TestVisitorDispatch::initTestCase()
+{
+    m_pool = new pool;
+    m_unit = createTranslationUnit(m_pool);
+}
+
+void TestVisitorDispatch::cleanupTestCase()
+{
+    delete m_pool;
+}
+
+void TestVisitorDispatch::testSameTraversal()
+{
+    TableNameCounter tableCounter;
+    tableCounter.visit(m_unit);
+
+    StaticNameCounter staticCounter;
+    staticCounter.visit(m_unit);
+
+    QCOMPARE(tableCounter.count, CLASS_COUNT * (1 + 2 * MEMBER_COUNT));
+    QCOMPARE(staticCounter.count, tableCounter.count);
+}
+
+void TestVisitorDispatch::testVisitOverride()
+{
+    TableNodeCounter tableCounter;
+    tableCounter.visit(m_unit);
+
+    StaticNodeCounter staticCounter;
+    staticCounter.visit(m_unit);
+
+    // The unit, four nodes per class and eight per member.
+    QCOMPARE(tableCounter.count, 1 + CLASS_COUNT * (4 + 8 * MEMBER_COUNT));
+    QCOMPARE(staticCounter.count, tableCounter.count);
+}
+
+void TestVisitorDispatch::benchmarkTableDispatch()
+{
+    QBENCHMARK {
+        TableNameCounter counter;
+        counter.visit(m_unit);
+    }
+}
+
+void TestVisitorDispatch::benchmarkStaticDispatch()
+{
+    QBENCHMARK {
+        StaticNameCounter counter;
+        counter.visit(m_unit);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestVisitorDispatch)
+
+#include "testvisitordispatch.moc"
@@ -36,7 +36,7 @@ typedef QMap<QString, QByteArray> ApiVersionMap;
 
 Q_GLOBAL_STATIC(ApiVersionMap, apiVersions)
 
-TypeDatabase::TypeDatabase() : m_suppressWarnings(true), m_apiVersion(0)
+TypeDatabase::TypeDatabase() : m_frozen(false), m_suppressWarnings(true), m_apiVersion(0), m_revision(0), m_lookupRevision(0), m_normalizedRevision(~0u)
 {
     addType(new VoidTypeEntry());
     addType(new VarargsTypeEntry());
@@ -53,24 +53,98 @@ TypeDatabase* TypeDatabase::instance(bool newInstance)
     return db;
 }
 
-QString TypeDatabase::normalizedSignature(const char* signature)
+static inline bool isWordChar(const QChar& c)
 {
-    QString normalized = QMetaObject::normalizedSignature(signature);
+    return c.isLetterOrNumber() || c == '_';
+}
 
-    if (!instance() || !QString(signature).contains("unsigned"))
-        return normalized;
+// Replaces the whole words of \a normalized found in \a rewrites, like
+// "uint", with their "unsigned int" spelling.
+static QString expandUnsignedTypes(const QString& normalized, const QStringList& rewrites)
+{
+    QString result;
+    result.reserve(normalized.size() + 16);
+    int i = 0;
+    while (i < normalized.size()) {
+        if (!isWordChar(normalized.at(i))) {
+            result += normalized.at(i++);
+            continue;
+        }
+        int start = i;
+        while (i < normalized.size() && isWordChar(normalized.at(i)))
+            ++i;
+        QStringRef word = normalized.midRef(start, i - start);
+        bool rewritten = false;
+        foreach (const QString& rewrite, rewrites) {
+            if (word == rewrite) {
+                result += "unsigned ";
+                result += word.mid(1);
+                rewritten = true;
+                break;
+            }
+        }
+        if (!rewritten)
+            result += word;
+    }
+    return result;
+}
 
+void TypeDatabase::updateUnsignedRewrites()
+{
+    m_normalizedSignatures.clear();
+    m_unsignedRewrites.clear();
     QStringList types;
     types << "char" << "short" << "int" << "long";
     foreach (const QString& type, types) {
-        if (instance()->findType(QString("u%1").arg(type)))
-            continue;
-        normalized.replace(QRegExp(QString("\\bu%1\\b").arg(type)), QString("unsigned %1").arg(type));
+        if (!findType("u" + type))
+            m_unsignedRewrites << "u" + type;
+    }
+    m_normalizedRevision = m_revision;
+}
+
+QString TypeDatabase::normalizedSignature(const char* signature)
+{
+    TypeDatabase* db = instance();
+    QByteArray rawSignature = QByteArray::fromRawData(signature, qstrlen(signature));
+
+    // A frozen database only reads the results cached before freeze()
+    if (db->m_frozen) {
+        QHash<QByteArray, QString>::const_iterator it = db->m_normalizedSignatures.constFind(rawSignature);
+        if (it != db->m_normalizedSignatures.constEnd())
+            return it.value();
+        QString normalized = QMetaObject::normalizedSignature(signature);
+        if (rawSignature.contains("unsigned"))
+            normalized = expandUnsignedTypes(normalized, db->m_unsignedRewrites);
+        return normalized;
     }
 
+    QMutexLocker locker(&db->m_normalizedSignaturesMutex);
+    if (db->m_normalizedRevision != db->m_revision)
+        db->updateUnsignedRewrites();
+
+    QHash<QByteArray, QString>::const_iterator it = db->m_normalizedSignatures.constFind(rawSignature);
+    if (it != db->m_normalizedSignatures.constEnd())
+        return it.value();
+
+    QString normalized = QMetaObject::normalizedSignature(signature);
+    if (rawSignature.contains("unsigned"))
+        normalized = expandUnsignedTypes(normalized, db->m_unsignedRewrites);
+
+    db->m_normalizedSignatures.insert(QByteArray(signature), normalized);
     return normalized;
 }
 
+void TypeDatabase::freeze()
+{
+    if (m_frozen)
+        return;
+    QMutexLocker locker(&m_normalizedSignaturesMutex);
+    if (m_normalizedRevision != m_revision)
+        updateUnsignedRewrites();
+    m_suppressedWarnings.freeze();
+    m_frozen = true;
+}
+
 QStringList TypeDatabase::requiredTargetImports() const
 {
     return m_requiredTargetImports;
@@ -78,12 +152,14 @@ QStringList TypeDatabase::requiredTargetImports() const
 
 void TypeDatabase::addRequiredTargetImport(const QString& moduleName)
 {
+    checkNotFrozen();
     if (!m_requiredTargetImports.contains(moduleName))
         m_requiredTargetImports << moduleName;
 }
 
 void TypeDatabase::addTypesystemPath(const QString& typesystem_paths)
 {
+    checkNotFrozen();
     #if defined(Q_OS_WIN32)
     char* path_splitter = const_cast<char*>(";");
     #else
@@ -109,6 +185,7 @@ ContainerTypeEntry* TypeDatabase::findContainerType(const QString &name) const
     if (pos > 0)
         template_name = name.left(pos);
 
+    // only when the name is not taken by another kind of entry first
     TypeEntry* type_entry = findType(template_name);
     if (type_entry && type_entry->isContainer())
         return static_cast<ContainerTypeEntry*>(type_entry);
@@ -126,31 +203,76 @@ FunctionTypeEntry* TypeDatabase::findFunctionType(const QString& name) const
 
 PrimitiveTypeEntry* TypeDatabase::findTargetLangPrimitiveType(const QString& targetLangName) const
 {
-    foreach (QList<TypeEntry*> entries, m_entries.values()) {
-        foreach (TypeEntry* e, entries) {
-            if (e && e->isPrimitive()) {
-                PrimitiveTypeEntry *pe = static_cast<PrimitiveTypeEntry*>(e);
-                if (pe->targetLangName() == targetLangName && pe->preferredConversion())
-                    return pe;
-            }
+    foreach (PrimitiveTypeEntry* pe, m_primitiveEntriesByTargetLangName.value(targetLangName)) {
+        if (pe->preferredConversion())
+            return pe;
+    }
+    return 0;
+}
+
+// The positions after each top level scope separator of the name,
+// leaving alone the ones inside template arguments
+static QList<int> scopeStarts(const QString& name)
+{
+    QList<int> starts;
+    int depth = 0;
+    for (int i = 0; i < name.size() - 1; ++i) {
+        QChar c = name.at(i);
+        if (c == '<')
+            ++depth;
+        else if (c == '>')
+            --depth;
+        else if (!depth && c == ':' && name.at(i + 1) == ':') {
+            starts << i + 2;
+            ++i;
         }
     }
+    return starts;
+}
 
-    return 0;
+QString TypeDatabase::typeLookupKey(const QString& name)
+{
+    QList<int> starts = scopeStarts(name);
+    QString key = starts.isEmpty() ? name : name.mid(starts.last());
+    int pos = key.indexOf('<');
+    return pos < 0 ? key : key.left(pos);
 }
 
 TypeEntry* TypeDatabase::findType(const QString& name) const
 {
-    QList<TypeEntry *> entries = findTypes(name);
-    foreach (TypeEntry *entry, entries) {
-        if (entry &&
-            (!entry->isPrimitive() || static_cast<PrimitiveTypeEntry *>(entry)->preferredTargetLangType())) {
+    TypeEntryHash::const_iterator it = m_entries.constFind(name);
+    if (it == m_entries.constEnd())
+        return 0;
+    foreach (TypeEntry *entry, it.value()) {
+        if (!entry->isPrimitive() || static_cast<PrimitiveTypeEntry *>(entry)->preferredTargetLangType())
             return entry;
-        }
     }
     return 0;
 }
 
+void TypeDatabase::addType(TypeEntry* e)
+{
+    checkNotFrozen();
+    QString name = e->qualifiedCppName();
+    m_entries[name].append(e);
+
+    if (e->isPrimitive()) {
+        PrimitiveTypeEntry* pe = static_cast<PrimitiveTypeEntry*>(e);
+        m_primitiveEntries[name].append(pe);
+        m_primitiveEntriesByTargetLangName[pe->targetLangName()].append(pe);
+    }
+    if (e->isComplex() && !m_complexEntries.contains(name))
+        m_complexEntries.insert(name, static_cast<ComplexTypeEntry*>(e));
+    if (e->isObject() && !m_objectEntries.contains(name))
+        m_objectEntries.insert(name, static_cast<ObjectTypeEntry*>(e));
+    if (e->isNamespace() && !m_namespaceEntries.contains(name))
+        m_namespaceEntries.insert(name, static_cast<NamespaceTypeEntry*>(e));
+    foreach (int pos, scopeStarts(name))
+        m_nestedTypeNames.insert(name.mid(pos));
+
+    m_typeLookupRevisions[typeLookupKey(name)] = ++m_revision;
+}
+
 SingleTypeEntryHash TypeDatabase::entries() const
 {
     TypeEntryHash entries = allEntries();
@@ -166,13 +288,10 @@ SingleTypeEntryHash TypeDatabase::entries() const
 
 QList<const PrimitiveTypeEntry*> TypeDatabase::primitiveTypes() const
 {
-    TypeEntryHash entries = allEntries();
     QList<const PrimitiveTypeEntry*> returned;
-    foreach(QString key, entries.keys()) {
-        foreach(const TypeEntry* typeEntry, entries[key]) {
-            if (typeEntry->isPrimitive())
-                returned.append((PrimitiveTypeEntry*) typeEntry);
-        }
+    foreach (const QList<PrimitiveTypeEntry*>& entries, m_primitiveEntries) {
+        foreach (const PrimitiveTypeEntry* entry, entries)
+            returned.append(entry);
     }
     return returned;
 }
@@ -192,13 +311,13 @@ QList<const ContainerTypeEntry*> TypeDatabase::containerTypes() const
 void TypeDatabase::addRejection(const QString& className, const QString& functionName,
                                 const QString& fieldName, const QString& enumName)
 {
-    TypeRejection r;
-    r.class_name = className;
-    r.function_name = functionName;
-    r.field_name = fieldName;
-    r.enum_name = enumName;
-
-    m_rejections << r;
+    checkNotFrozen();
+    if (functionName == "*" && fieldName == "*" && enumName == "*")
+        m_rejectedClasses << className;
+    m_rejectedFunctions << qMakePair(className, functionName);
+    m_rejectedFields << qMakePair(className, fieldName);
+    m_rejectedEnums << qMakePair(className, enumName);
+    m_lookupRevision = ++m_revision;
 }
 
 bool TypeDatabase::isClassRejected(const QString& className) const
@@ -206,42 +325,29 @@ bool TypeDatabase::isClassRejected(const QString& className) const
     if (!m_rebuildClasses.isEmpty())
         return !m_rebuildClasses.contains(className);
 
-    foreach (const TypeRejection& r, m_rejections)
-    if (r.class_name == className && r.function_name == "*" && r.field_name == "*" && r.enum_name == "*")
-        return true;
+    return m_rejectedClasses.contains(className);
+}
 
-    return false;
+static bool isMemberRejected(const QSet<QPair<QString, QString> >& rejections,
+                             const QString& className, const QString& memberName)
+{
+    return rejections.contains(qMakePair(className, memberName))
+           || rejections.contains(qMakePair(QString("*"), memberName));
 }
 
 bool TypeDatabase::isEnumRejected(const QString& className, const QString& enumName) const
 {
-    foreach (const TypeRejection& r, m_rejections) {
-        if (r.enum_name == enumName
-            && (r.class_name == className || r.class_name == "*")) {
-            return true;
-        }
-    }
-
-    return false;
+    return isMemberRejected(m_rejectedEnums, className, enumName);
 }
 
 bool TypeDatabase::isFunctionRejected(const QString& className, const QString& functionName) const
 {
-    foreach (const TypeRejection& r, m_rejections)
-    if (r.function_name == functionName &&
-        (r.class_name == className || r.class_name == "*"))
-        return true;
-    return false;
+    return isMemberRejected(m_rejectedFunctions, className, functionName);
 }
 
-
 bool TypeDatabase::isFieldRejected(const QString& className, const QString& fieldName) const
 {
-    foreach (const TypeRejection& r, m_rejections)
-    if (r.field_name == fieldName &&
-        (r.class_name == className || r.class_name == "*"))
-        return true;
-    return false;
+    return isMemberRejected(m_rejectedFields, className, fieldName);
 }
 
 FlagsTypeEntry* TypeDatabase::findFlagsType(const QString &name) const
@@ -250,18 +356,28 @@ FlagsTypeEntry* TypeDatabase::findFlagsType(const QString &name) const
     if (!fte) {
         fte = (FlagsTypeEntry*) m_flagsEntries.value(name);
         if (!fte) {
-            //last hope, search for flag without scope  inside of flags hash
-            foreach(QString key, m_flagsEntries.keys()) {
-                if (key.endsWith(name)) {
-                    fte = (FlagsTypeEntry*) m_flagsEntries.value(key);
-                    break;
-                }
-            }
+            //last hope, search for flag without scope inside of flags hash
+            fte = m_flagsEntriesBySuffix.value(name);
         }
     }
     return fte;
 }
 
+void TypeDatabase::addFlagsType(FlagsTypeEntry* fte)
+{
+    checkNotFrozen();
+    QString name = fte->originalName();
+    m_flagsEntries[name] = fte;
+
+    foreach (int pos, scopeStarts(name)) {
+        QString suffix = name.mid(pos);
+        if (!m_flagsEntriesBySuffix.contains(suffix))
+            m_flagsEntriesBySuffix.insert(suffix, fte);
+    }
+
+    m_lookupRevision = ++m_revision;
+}
+
 AddedFunctionList TypeDatabase::findGlobalUserFunctions(const QString& name) const
 {
     AddedFunctionList addedFunctions;
@@ -280,14 +396,7 @@ QString TypeDatabase::globalNamespaceClassName(const TypeEntry * /*entry*/)
 
 FunctionModificationList TypeDatabase::functionModifications(const QString& signature) const
 {
-    FunctionModificationList lst;
-    for (int i = 0; i < m_functionMods.count(); ++i) {
-        const FunctionModification& mod = m_functionMods.at(i);
-        if (mod.signature == signature)
-            lst << mod;
-    }
-
-    return lst;
+    return m_functionModsBySignature.value(signature);
 }
 
 bool TypeDatabase::isSuppressedWarning(const QString& s) const
@@ -295,24 +404,7 @@ bool TypeDatabase::isSuppressedWarning(const QString& s) const
     if (!m_suppressWarnings)
         return false;
 
-    foreach (const QString &_warning, m_suppressedWarnings) {
-        QString warning(QString(_warning).replace("\\*", "&place_holder_for_asterisk;"));
-
-        QStringList segs = warning.split("*", QString::SkipEmptyParts);
-        if (!segs.size())
-            continue;
-
-        int i = 0;
-        int pos = s.indexOf(QString(segs.at(i++)).replace("&place_holder_for_asterisk;", "*"));
-        //qDebug() << "s == " << s << ", warning == " << segs;
-        while (pos != -1) {
-            if (i == segs.size())
-                return true;
-            pos = s.indexOf(QString(segs.at(i++)).replace("&place_holder_for_asterisk;", "*"), pos);
-        }
-    }
-
-    return false;
+    return m_suppressedWarnings.matches(s);
 }
 
 QString TypeDatabase::modifiedTypesystemFilepath(const QString& tsFile) const
@@ -354,6 +446,7 @@ bool TypeDatabase::parseFile(const QString &filename, bool generate)
 
 bool TypeDatabase::parseFile(QIODevice* device, bool generate)
 {
+    checkNotFrozen();
     if (m_apiVersion) // backwards compatibility with deprecated API
         setApiVersion("*", QByteArray::number(m_apiVersion));
 
@@ -369,44 +462,26 @@ bool TypeDatabase::parseFile(QIODevice* device, bool generate)
 
 PrimitiveTypeEntry *TypeDatabase::findPrimitiveType(const QString& name) const
 {
-    QList<TypeEntry*> entries = findTypes(name);
-
-    foreach (TypeEntry* entry, entries) {
-        if (entry && entry->isPrimitive() && static_cast<PrimitiveTypeEntry*>(entry)->preferredTargetLangType())
-            return static_cast<PrimitiveTypeEntry*>(entry);
+    foreach (PrimitiveTypeEntry* entry, m_primitiveEntries.value(name)) {
+        if (entry->preferredTargetLangType())
+            return entry;
     }
-
     return 0;
 }
 
 ComplexTypeEntry* TypeDatabase::findComplexType(const QString& name) const
 {
-    QList<TypeEntry*> entries = findTypes(name);
-    foreach (TypeEntry* entry, entries) {
-        if (entry && entry->isComplex())
-            return static_cast<ComplexTypeEntry*>(entry);
-    }
-    return 0;
+    return m_complexEntries.value(name);
 }
 
 ObjectTypeEntry* TypeDatabase::findObjectType(const QString& name) const
 {
-    QList<TypeEntry*> entries = findTypes(name);
-    foreach (TypeEntry* entry, entries) {
-        if (entry && entry->isObject())
-            return static_cast<ObjectTypeEntry*>(entry);
-    }
-    return 0;
+    return m_objectEntries.value(name);
 }
 
 NamespaceTypeEntry* TypeDatabase::findNamespaceType(const QString& name) const
 {
-    QList<TypeEntry*> entries = findTypes(name);
-    foreach (TypeEntry* entry, entries) {
-        if (entry && entry->isNamespace())
-            return static_cast<NamespaceTypeEntry*>(entry);
-    }
-    return 0;
+    return m_namespaceEntries.value(name);
 }
 
 bool TypeDatabase::supportedApiVersion(double version) const
@@ -421,8 +496,10 @@ bool TypeDatabase::shouldDropTypeEntry(const QString& fullTypeName) const
 
 void TypeDatabase::setDropTypeEntries(QStringList dropTypeEntries)
 {
+    checkNotFrozen();
     m_dropTypeEntries = dropTypeEntries;
     m_dropTypeEntries.sort();
+    m_lookupRevision = ++m_revision;
 }
 
 // Using std::pair to save some memory
@@ -505,6 +582,7 @@ int getMaxTypeIndex()
 
 void TypeDatabase::setApiVersion(const QString& package, const QByteArray& version)
 {
+    checkNotFrozen();
     (*apiVersions())[package.trimmed()] = version.trimmed();
 }
 
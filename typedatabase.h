@@ -24,8 +24,11 @@
 #ifndef TYPEDATABASE_H
 #define TYPEDATABASE_H
 
+#include <QMutex>
+#include <QSet>
 #include <QStringList>
 #include "typesystem.h"
+#include "suppressedwarningmatcher.h"
 
 APIEXTRACTOR_API void setTypeRevision(TypeEntry* typeEntry, int revision);
 APIEXTRACTOR_API int getTypeRevision(const TypeEntry* typeEntry);
@@ -50,6 +53,17 @@ public:
 
     static QString normalizedSignature(const char* signature);
 
+    /**
+    *   Finalizes the lookup caches and makes the database read-only: after
+    *   this all the const queries may be called from several threads
+    *   without locking, and any modification asserts in debug builds.
+    */
+    void freeze();
+    bool isFrozen() const
+    {
+        return m_frozen;
+    }
+
     QStringList requiredTargetImports() const;
 
     void addRequiredTargetImport(const QString& moduleName);
@@ -97,9 +111,31 @@ public:
     bool isFieldRejected(const QString& className, const QString& fieldName) const;
     bool isEnumRejected(const QString& className, const QString& enumName) const;
 
-    void addType(TypeEntry* e)
+    void addType(TypeEntry* e);
+
+    // changes whenever the result of a type lookup or rejection check may
+    // change; lets callers validate what they derived from them
+    uint revision() const
+    {
+        return m_revision;
+    }
+
+    // the part of a type name its lookups depend on: the last scope of
+    // the name without its template arguments, "C" for "A::B<int>::C"
+    static QString typeLookupKey(const QString& name);
+
+    // the revision at which the lookups of the names with this key may
+    // have last changed, by an entry added or by a rejection
+    uint typeLookupRevision(const QString& key) const
     {
-        m_entries[e->qualifiedCppName()].append(e);
+        return qMax(m_lookupRevision, m_typeLookupRevisions.value(key));
+    }
+
+    // whether the name is a scope-less suffix of an entry name, as "B::C"
+    // and "C" for "A::B::C"
+    bool isNestedTypeName(const QString& name) const
+    {
+        return m_nestedTypeNames.contains(name);
     }
 
     SingleTypeEntryHash flagsEntries() const
@@ -107,10 +143,7 @@ public:
         return m_flagsEntries;
     }
     FlagsTypeEntry* findFlagsType(const QString& name) const;
-    void addFlagsType(FlagsTypeEntry* fte)
-    {
-        m_flagsEntries[fte->originalName()] = fte;
-    }
+    void addFlagsType(FlagsTypeEntry* fte);
 
     TemplateEntry* findTemplate(const QString& name) const
     {
@@ -119,6 +152,7 @@ public:
 
     void addTemplate(TemplateEntry* t)
     {
+        checkNotFrozen();
         m_templates[t->name()] = t;
     }
 
@@ -129,6 +163,7 @@ public:
 
     void addGlobalUserFunctions(const AddedFunctionList& functions)
     {
+        checkNotFrozen();
         m_globalUserFunctions << functions;
     }
 
@@ -136,31 +171,37 @@ public:
 
     void addGlobalUserFunctionModifications(const FunctionModificationList& functionModifications)
     {
-        m_functionMods << functionModifications;
+        foreach (const FunctionModification& mod, functionModifications)
+            addGlobalUserFunctionModification(mod);
     }
 
     void addGlobalUserFunctionModification(const FunctionModification& functionModification)
     {
-        m_functionMods << functionModification;
+        checkNotFrozen();
+        m_functionModsBySignature[functionModification.signature] << functionModification;
     }
 
     FunctionModificationList functionModifications(const QString& signature) const;
 
     void setSuppressWarnings(bool on)
     {
+        checkNotFrozen();
         m_suppressWarnings = on;
     }
 
     void addSuppressedWarning(const QString& s)
     {
-        m_suppressedWarnings.append(s);
+        checkNotFrozen();
+        m_suppressedWarnings.addPattern(s);
     }
 
     bool isSuppressedWarning(const QString& s) const;
 
     void setRebuildClasses(const QStringList &cls)
     {
+        checkNotFrozen();
         m_rebuildClasses = cls;
+        m_lookupRevision = ++m_revision;
     }
 
     static QString globalNamespaceClassName(const TypeEntry *te);
@@ -180,6 +221,7 @@ public:
 
     APIEXTRACTOR_DEPRECATED(void setApiVersion(double version))
     {
+        checkNotFrozen();
         m_apiVersion = version;
     }
     void setApiVersion(const QString& package, const QByteArray& version);
@@ -202,25 +244,65 @@ public:
     void setDropTypeEntries(QStringList dropTypeEntries);
 
 private:
+    void checkNotFrozen() const
+    {
+        Q_ASSERT_X(!m_frozen, "TypeDatabase", "modified after freeze()");
+    }
+    void updateUnsignedRewrites();
+
+    bool m_frozen;
     bool m_suppressWarnings;
     TypeEntryHash m_entries;
     SingleTypeEntryHash m_flagsEntries;
+
+    // Kind-specific views of m_entries, filled by addType(); apart from
+    // the primitive types, whose lookups also depend on their preference
+    // flags, only the first entry of each kind and name is kept
+    QHash<QString, QList<PrimitiveTypeEntry*> > m_primitiveEntries;
+    QHash<QString, QList<PrimitiveTypeEntry*> > m_primitiveEntriesByTargetLangName;
+    QHash<QString, ComplexTypeEntry*> m_complexEntries;
+    QHash<QString, ObjectTypeEntry*> m_objectEntries;
+    QHash<QString, NamespaceTypeEntry*> m_namespaceEntries;
+    // flags by each of their scope-less suffixes, "A::B::Flags" being
+    // found by "B::Flags" and "Flags"; the first flags added wins
+    QHash<QString, FlagsTypeEntry*> m_flagsEntriesBySuffix;
     TemplateEntryHash m_templates;
-    QStringList m_suppressedWarnings;
+    SuppressedWarningMatcher m_suppressedWarnings;
 
     AddedFunctionList m_globalUserFunctions;
-    FunctionModificationList m_functionMods;
+    // global function modifications by signature, in declaration order
+    QHash<QString, FunctionModificationList> m_functionModsBySignature;
 
     QStringList m_requiredTargetImports;
 
     QStringList m_typesystemPaths;
     QHash<QString, bool> m_parsedTypesystemFiles;
 
-    QList<TypeRejection> m_rejections;
+    // Rejections by kind, as (class name, member name) pairs; the class
+    // name may be the "*" wildcard
+    typedef QSet<QPair<QString, QString> > RejectionSet;
+    QSet<QString> m_rejectedClasses;
+    RejectionSet m_rejectedFunctions;
+    RejectionSet m_rejectedFields;
+    RejectionSet m_rejectedEnums;
     QStringList m_rebuildClasses;
 
     double m_apiVersion;
     QStringList m_dropTypeEntries;
+    uint m_revision;
+    // the revision of the last change to all the type lookups, and of
+    // the last entry added by typeLookupKey()
+    uint m_lookupRevision;
+    QHash<QString, uint> m_typeLookupRevisions;
+    QSet<QString> m_nestedTypeNames;
+
+    // normalizedSignature() results by raw signature, valid for the
+    // revision m_normalizedRevision, and the "uint"-like spellings that
+    // get expanded to "unsigned int" because they are not types themselves
+    QMutex m_normalizedSignaturesMutex;
+    QHash<QByteArray, QString> m_normalizedSignatures;
+    QStringList m_unsignedRewrites;
+    uint m_normalizedRevision;
 };
 
 #endif
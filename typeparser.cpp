@@ -23,8 +23,10 @@
 
 #include "typeparser.h"
 
+#include <QtCore/QCache>
 #include <QtCore/QDebug>
-#include <QtCore/QStack>
+#include <QtCore/QMutex>
+#include <QtCore/QVarLengthArray>
 
 class Scanner
 {
@@ -47,23 +49,24 @@ public:
     };
 
     Scanner(const QString &s)
-            : m_pos(0), m_length(s.length()), m_chars(s.constData())
+            : m_string(s), m_pos(0), m_length(s.length()), m_chars(s.constData())
     {
     }
 
     Token nextToken();
-    QString identifier() const;
+    QStringRef identifier() const;
 
 private:
+    const QString &m_string;
     int m_pos;
     int m_length;
     int m_tokenStart;
     const QChar *m_chars;
 };
 
-QString Scanner::identifier() const
+QStringRef Scanner::identifier() const
 {
-    return QString(m_chars + m_tokenStart, m_pos - m_tokenStart);
+    return QStringRef(&m_string, m_tokenStart, m_pos - m_tokenStart);
 }
 
 Scanner::Token Scanner::nextToken()
@@ -131,17 +134,17 @@ Scanner::Token Scanner::nextToken()
 
 }
 
-TypeParser::Info TypeParser::parse(const QString &str)
+static TypeParser::Info parseType(const QString &str)
 {
     Scanner scanner(str);
 
-    Info info;
-    QStack<Info *> stack;
-    stack.push(&info);
+    TypeParser::Info info;
+    TypeParser::Info *current = &info;
+    QVarLengthArray<TypeParser::Info *, 8> enclosing;
 
     bool colon_prefix = false;
     bool in_array = false;
-    QString array;
+    QStringRef array;
 
     Scanner::Token tok = scanner.nextToken();
     while (tok != Scanner::NoToken) {
@@ -164,39 +167,49 @@ TypeParser::Info TypeParser::parse(const QString &str)
         switch (tok) {
 
         case Scanner::StarToken:
-            ++stack.top()->indirections;
+            ++current->indirections;
             break;
 
         case Scanner::AmpersandToken:
-            stack.top()->is_reference = true;
+            current->is_reference = true;
             break;
 
         case Scanner::LessThanToken:
-            stack.top()->template_instantiations << Info();
-            stack.push(&stack.top()->template_instantiations.last());
+            current->template_instantiations << TypeParser::Info();
+            enclosing.append(current);
+            current = &current->template_instantiations.last();
             break;
 
         case Scanner::CommaToken:
-            stack.pop();
-            stack.top()->template_instantiations << Info();
-            stack.push(&stack.top()->template_instantiations.last());
-            break;
-
-        case Scanner::GreaterThanToken:
-            stack.pop();
+        case Scanner::GreaterThanToken: {
+            // unbalanced, like "int>" coming from a type system file
+            if (enclosing.isEmpty()) {
+                TypeParser::Info i;
+                i.is_busted = true;
+                return i;
+            }
+            TypeParser::Info *outer = enclosing[enclosing.size() - 1];
+            if (tok == Scanner::CommaToken) {
+                outer->template_instantiations << TypeParser::Info();
+                current = &outer->template_instantiations.last();
+            } else {
+                current = outer;
+                enclosing.resize(enclosing.size() - 1);
+            }
             break;
+        }
 
         case Scanner::ColonToken:
             colon_prefix = true;
             break;
 
         case Scanner::ConstToken:
-            stack.top()->is_constant = true;
+            current->is_constant = true;
             break;
 
         case Scanner::OpenParenToken: // function pointers not supported
         case Scanner::CloseParenToken: {
-            Info i;
+            TypeParser::Info i;
             i.is_busted = true;
             return i;
         }
@@ -205,11 +218,13 @@ TypeParser::Info TypeParser::parse(const QString &str)
         case Scanner::Identifier:
             if (in_array) {
                 array = scanner.identifier();
-            } else if (colon_prefix || stack.top()->qualified_name.isEmpty()) {
-                stack.top()->qualified_name << scanner.identifier();
+            } else if (colon_prefix || current->qualified_name.isEmpty()) {
+                QStringRef name = scanner.identifier();
+                // A plain "int" or "QString" shares the caller's string
+                current->qualified_name << (name.size() == str.size() ? str : name.toString());
                 colon_prefix = false;
             } else {
-                stack.top()->qualified_name.last().append(" " + scanner.identifier());
+                current->qualified_name.last().append(QLatin1Char(' ')).append(scanner.identifier());
             }
             break;
 
@@ -219,7 +234,7 @@ TypeParser::Info TypeParser::parse(const QString &str)
 
         case Scanner::SquareEnd:
             in_array = false;
-            stack.top()->arrays += array;
+            current->arrays += array.toString();
             break;
 
 
@@ -233,12 +248,34 @@ TypeParser::Info TypeParser::parse(const QString &str)
     return info;
 }
 
+// Type strings repeat a lot (every "const QString&" argument, every
+// instantiation of a container), so the results of the last parses are
+// kept around. Info only holds implicitly shared members, so handing out
+// a cached copy costs a few reference count increments.
+static const int TYPE_PARSER_MEMO_SIZE = 1024;
+static QMutex typeParserMemoMutex;
+static QCache<QString, TypeParser::Info> typeParserMemo(TYPE_PARSER_MEMO_SIZE);
+
+TypeParser::Info TypeParser::parse(const QString &str)
+{
+    QMutexLocker locker(&typeParserMemoMutex);
+    if (const Info *cached = typeParserMemo.object(str))
+        return *cached;
+    locker.unlock();
+
+    Info info = parseType(str);
+
+    locker.relock();
+    typeParserMemo.insert(str, new Info(info));
+    return info;
+}
+
 QString TypeParser::Info::instantiationName() const
 {
     QString s(qualified_name.join("::"));
     if (!template_instantiations.isEmpty()) {
         QStringList insts;
-        foreach (Info info, template_instantiations)
+        foreach (const Info &info, template_instantiations)
             insts << info.toString();
         s += QString("< %1 >").arg(insts.join(", "));
     }
@@ -46,6 +46,11 @@ public:
         QString instantiationName() const;
     };
 
+    /**
+    * Parses a type string like "const QList<int>*&". Results for recently
+    * parsed strings are memoized, so calling this repeatedly for the same
+    * type is cheap and safe from several threads.
+    */
     static Info parse(const QString &str);
 };
 
@@ -1844,13 +1844,7 @@ QString Modification::accessModifierString() const
 
 FunctionModificationList ComplexTypeEntry::functionModifications(const QString &signature) const
 {
-    FunctionModificationList lst;
-    for (int i = 0; i < m_functionMods.count(); ++i) {
-        const FunctionModification &mod = m_functionMods.at(i);
-        if (mod.signature == signature)
-            lst << mod;
-    }
-    return lst;
+    return m_functionModsBySignature.value(signature);
 }
 
 FieldModification ComplexTypeEntry::fieldModification(const QString &name) const
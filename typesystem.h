@@ -1483,10 +1483,14 @@ public:
     void setFunctionModifications(const FunctionModificationList &functionModifications)
     {
         m_functionMods = functionModifications;
+        m_functionModsBySignature.clear();
+        foreach (const FunctionModification &mod, m_functionMods)
+            m_functionModsBySignature[mod.signature] << mod;
     }
     void addFunctionModification(const FunctionModification &functionModification)
     {
         m_functionMods << functionModification;
+        m_functionModsBySignature[functionModification.signature] << functionModification;
     }
     FunctionModificationList functionModifications(const QString &signature) const;
 
@@ -1647,6 +1651,8 @@ public:
 private:
     AddedFunctionList m_addedFunctions;
     FunctionModificationList m_functionMods;
+    // m_functionMods grouped by signature, in declaration order
+    QHash<QString, FunctionModificationList> m_functionModsBySignature;
     FieldModificationList m_fieldMods;
     QString m_package;
     QString m_defaultSuperclass;